@@ -0,0 +1,94 @@
+#pragma once
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace bench
+{
+    using clock = std::chrono::steady_clock;
+
+    struct options
+    {
+        bool quick = false;      // shorter runs for smoke testing, numbers are noisier
+        std::string filter = {}; // only suites whose name contains this
+        std::string json_path = "bench.json";
+
+        std::size_t scale(std::size_t iterations) const noexcept { return quick ? std::max<std::size_t>(iterations / 20, 1) : iterations; }
+        clock::duration run_time() const noexcept { return quick ? std::chrono::milliseconds(50) : std::chrono::milliseconds(400); }
+    };
+
+    // one measured case: integer parameters describe the setup, metrics hold the numbers to track
+    struct result
+    {
+        std::string suite;
+        std::string name;
+        std::vector<std::pair<std::string, std::int64_t>> params;
+        std::vector<std::pair<std::string, double>> metrics;
+    };
+
+    class report
+    {
+        std::vector<result> results;
+        std::atomic<std::size_t> failures = { 0 };
+
+    public:
+        // a sanity check that failed, the run goes on but the process exits non-zero. any thread may call it
+        template <typename... Args> void fail(fmt::format_string<Args...> format, Args&&... args)
+        {
+            fmt::print(stderr, "{}\n", fmt::format(format, std::forward<Args>(args)...));
+            failures.fetch_add(1, std::memory_order_relaxed);
+        }
+        bool failed() const noexcept { return failures.load(std::memory_order_relaxed) != 0; }
+
+        void add(result entry)
+        {
+            auto line = fmt::format("{:<10} {:<34}", entry.suite, entry.name);
+            for (auto& [key, value] : entry.params)
+                line += fmt::format(" {}={}", key, value);
+            for (auto& [key, value] : entry.metrics)
+                line += fmt::format(" {}={:.1f}", key, value);
+            fmt::print("{}\n", line);
+            results.push_back(std::move(entry));
+        }
+        const std::vector<result>& entries() const noexcept { return results; }
+    };
+
+    template <typename Fn> double ns_per_op(std::size_t iterations, Fn&& fn)
+    {
+        auto begin = clock::now();
+        for (std::size_t i = 0; i < iterations; i++)
+            fn(i);
+        auto elapsed = clock::now() - begin;
+        return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+    }
+
+    // nearest-rank percentile of samples in nanoseconds, sorts in place
+    inline double percentile(std::vector<double>& samples, double fraction)
+    {
+        if (samples.empty())
+            return 0;
+        std::sort(samples.begin(), samples.end());
+        auto rank = static_cast<std::size_t>(fraction * static_cast<double>(samples.size() - 1));
+        return samples[rank];
+    }
+
+    inline double nanoseconds(clock::duration duration) { return std::chrono::duration<double, std::nano>(duration).count(); }
+
+    // every suite lives in its own translation unit
+    void run_registry(report& out, const options& opts);
+    void run_syncer(report& out, const options& opts);
+    void run_channel(report& out, const options& opts);
+    void run_async_pool(report& out, const options& opts);
+    void run_timer(report& out, const options& opts);
+    void run_executor(report& out, const options& opts);
+    void run_algorithm(report& out, const options& opts);
+    void run_containers(report& out, const options& opts);
+} // namespace bench
@@ -0,0 +1,62 @@
+#include "bench.hpp"
+
+#include <parallel_algorithm.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace
+{
+    template <typename Fn> double milliseconds(Fn&& fn)
+    {
+        auto begin = bench::clock::now();
+        fn();
+        return bench::nanoseconds(bench::clock::now() - begin) / 1e6;
+    }
+
+    // each case against its sequential std:: counterpart on the same data
+    void compare(bench::report& out, const char* name, std::size_t size, std::size_t grain, double sequential, double parallel)
+    {
+        out.add({ "algorithm",
+                  name,
+                  { { "elements", static_cast<std::int64_t>(size) }, { "grain", static_cast<std::int64_t>(grain) } },
+                  { { "sequential_ms", sequential }, { "parallel_ms", parallel }, { "speedup", sequential / parallel } } });
+    }
+} // namespace
+
+void bench::run_algorithm(report& out, const options& opts)
+{
+    auto& pool = stdex::detail::default_pool;
+    auto size = opts.scale(4000000);
+    std::vector<double> values(size);
+    std::iota(values.begin(), values.end(), 0.0);
+    std::vector<double> results(size);
+
+    // grain 0 lets the pool pick about eight chunks per worker
+    for (std::size_t grain : { 0, 1024, 65536 })
+    {
+        auto sequential = milliseconds([&] { std::transform(values.begin(), values.end(), results.begin(), [](double x) { return std::sqrt(x); }); });
+        auto parallel = milliseconds([&] { stdex::parallel_transform(pool, values, results.begin(), [](double x) { return std::sqrt(x); }, grain); });
+        compare(out, "parallel_transform sqrt", size, grain, sequential, parallel);
+
+        double sum = 0;
+        sequential = milliseconds([&] { sum = std::accumulate(values.begin(), values.end(), 0.0); });
+        parallel = milliseconds([&] { sum -= stdex::parallel_reduce(pool, values, 0.0, std::plus<>{}, grain); });
+        compare(out, "parallel_reduce sum", size, grain, sequential, parallel);
+        if (std::abs(sum) > 1e-3 * static_cast<double>(size) * static_cast<double>(size))
+            out.fail("parallel_reduce disagrees with accumulate by {}", sum);
+    }
+
+    std::mt19937_64 random(42);
+    std::vector<std::uint64_t> unsorted(size);
+    for (auto& value : unsorted)
+        value = random();
+    auto copy = unsorted;
+    auto sequential = milliseconds([&] { std::sort(copy.begin(), copy.end()); });
+    copy = unsorted;
+    auto parallel = milliseconds([&] { stdex::parallel_sort(pool, copy); });
+    compare(out, "parallel_sort uint64", size, 0, sequential, parallel);
+}
@@ -0,0 +1,82 @@
+#include "bench.hpp"
+
+#include <self_releasing_async.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+    // start() to first instruction of the body, one task at a time so nothing queues behind another
+    void spawn_latency(bench::report& out, stdex::launch_mode mode, const char* name, std::size_t rounds)
+    {
+        stdex::detail::async_pool pool(mode);
+        std::vector<double> samples(rounds);
+        for (std::size_t i = 0; i < rounds; i++)
+        {
+            auto begin = bench::clock::now();
+            auto id = pool.start("bench.spawn", [&samples, i, begin] { samples[i] = bench::nanoseconds(bench::clock::now() - begin); });
+            pool.wait(id);
+        }
+        auto p50 = bench::percentile(samples, 0.50);
+        auto p99 = bench::percentile(samples, 0.99);
+        out.add({ "pool", name, {}, { { "p50_ns", p50 }, { "p99_ns", p99 } } });
+    }
+
+    // cost of the start() call itself and of draining a burst of empty tasks
+    void spawn_burst(bench::report& out, std::size_t count)
+    {
+        stdex::detail::async_pool pool;
+        std::atomic<std::size_t> done = { 0 };
+        auto begin = bench::clock::now();
+        auto start = bench::ns_per_op(count, [&](std::size_t) { pool.start("bench.burst", [&done] { done.fetch_add(1, std::memory_order_relaxed); }); });
+        while (done.load() != count || pool.has("bench.burst"))
+            std::this_thread::yield();
+        auto seconds = std::chrono::duration<double>(bench::clock::now() - begin).count();
+        // the arena keeps the burst's peak, every later burst of the same size allocates nothing new
+        auto memory = pool.stats().memory;
+        out.add({ "pool",
+                  "worker_pool burst",
+                  { { "tasks", static_cast<std::int64_t>(count) } },
+                  { { "start_ns", start }, { "tasks_per_s", static_cast<double>(count) / seconds }, { "arena_kib", static_cast<double>(memory.reserved_bytes) / 1024 } } });
+    }
+
+    // start() to body of one latency critical task queued behind a backlog of bulk ones, with and without priorities
+    void behind_backlog(bench::report& out, bool prioritized, std::size_t backlog, std::size_t rounds)
+    {
+        stdex::detail::async_pool pool;
+        if (prioritized)
+        {
+            pool.configure("bench.bulk", { stdex::task_priority::low });
+            pool.configure("bench.urgent", { stdex::task_priority::high });
+        }
+        std::vector<double> samples(rounds);
+        for (std::size_t i = 0; i < rounds; i++)
+        {
+            for (std::size_t b = 0; b < backlog; b++)
+                pool.start("bench.bulk", [] {
+                    auto until = bench::clock::now() + std::chrono::microseconds(2);
+                    while (bench::clock::now() < until)
+                        ;
+                });
+            auto begin = bench::clock::now();
+            auto id = pool.start("bench.urgent", [&samples, i, begin] { samples[i] = bench::nanoseconds(bench::clock::now() - begin); });
+            pool.wait(id);
+            pool.wait_all("bench.bulk");
+        }
+        auto p50 = bench::percentile(samples, 0.50);
+        auto p99 = bench::percentile(samples, 0.99);
+        out.add({ "pool", prioritized ? "urgent behind bulk, high priority" : "urgent behind bulk, same priority", { { "backlog", static_cast<std::int64_t>(backlog) } }, { { "p50_ns", p50 }, { "p99_ns", p99 } } });
+    }
+} // namespace
+
+void bench::run_async_pool(report& out, const options& opts)
+{
+    spawn_latency(out, stdex::launch_mode::worker_pool, "worker_pool spawn latency", opts.scale(20000));
+    spawn_latency(out, stdex::launch_mode::thread_per_task, "thread_per_task spawn latency", opts.scale(2000));
+    spawn_burst(out, opts.scale(200000));
+    behind_backlog(out, false, 1000, opts.scale(200));
+    behind_backlog(out, true, 1000, opts.scale(200));
+}
@@ -0,0 +1,197 @@
+#include "bench.hpp"
+
+#include <channel.hpp>
+#include <coroutine.hpp>
+#include <pipeline.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // every producer sends count messages, consumers receive until the channel is closed and drained
+    template <typename Channel> void throughput(bench::report& out, const char* name, std::size_t producers, std::size_t consumers, std::size_t count, Channel& channel)
+    {
+        auto begin = bench::clock::now();
+        {
+            std::vector<std::jthread> receivers;
+            for (std::size_t c = 0; c < consumers; c++)
+                receivers.emplace_back([&] {
+                    std::uint64_t value;
+                    while (channel.recv(value) == stdex::channel_status::ok)
+                        ;
+                });
+            {
+                std::vector<std::jthread> senders;
+                for (std::size_t p = 0; p < producers; p++)
+                    senders.emplace_back([&] {
+                        for (std::uint64_t i = 0; i < count; i++)
+                            channel.send(i);
+                    });
+            }
+            channel.close();
+        }
+        auto seconds = std::chrono::duration<double>(bench::clock::now() - begin).count();
+        out.add({ "channel",
+                  name,
+                  { { "producers", static_cast<std::int64_t>(producers) }, { "consumers", static_cast<std::int64_t>(consumers) } },
+                  { { "messages_per_s", static_cast<double>(producers * count) / seconds } } });
+    }
+
+    void batched(bench::report& out, std::size_t count)
+    {
+        constexpr std::size_t batch = 64;
+        stdex::bounded_channel<std::uint64_t, stdex::channel_kind::spsc> channel(1024);
+        auto begin = bench::clock::now();
+        {
+            std::jthread receiver([&] {
+                std::array<std::uint64_t, batch> values;
+                while (channel.recv_n(values.begin(), batch) != 0)
+                    ;
+            });
+            std::array<std::uint64_t, batch> values = {};
+            for (std::size_t sent = 0; sent < count; sent += batch)
+                channel.send_n(values.begin(), batch);
+            channel.close();
+        }
+        auto seconds = std::chrono::duration<double>(bench::clock::now() - begin).count();
+        out.add({ "channel", "bounded spsc send_n/recv_n", { { "batch", static_cast<std::int64_t>(batch) } }, { { "messages_per_s", static_cast<double>(count) / seconds } } });
+    }
+
+    // one message bounces between two threads, half the round trip is the hand-off latency
+    void ping_pong(bench::report& out, std::size_t rounds, std::uint32_t spin_count)
+    {
+        stdex::bounded_channel<std::uint64_t, stdex::channel_kind::spsc> ping(16);
+        stdex::bounded_channel<std::uint64_t, stdex::channel_kind::spsc> pong(16);
+        ping.set_spin_count(spin_count);
+        pong.set_spin_count(spin_count);
+        std::jthread echo([&] {
+            std::uint64_t value;
+            while (ping.recv(value) == stdex::channel_status::ok)
+                pong.send(value);
+        });
+
+        std::vector<double> samples;
+        samples.reserve(rounds);
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i < rounds; i++)
+        {
+            auto begin = bench::clock::now();
+            ping.send(i);
+            pong.recv(value);
+            samples.push_back(bench::nanoseconds(bench::clock::now() - begin) / 2);
+        }
+        ping.close();
+        auto p50 = bench::percentile(samples, 0.50);
+        auto p99 = bench::percentile(samples, 0.99);
+        out.add({ "channel", "bounded spsc one-way latency", { { "spin_count", spin_count } }, { { "p50_ns", p50 }, { "p99_ns", p99 } } });
+    }
+
+    // the same producer / consumer shape as coroutines multiplexed onto the default pool
+    void coroutines(bench::report& out, std::size_t producers, std::size_t consumers, std::size_t count)
+    {
+        auto& pool = stdex::detail::default_pool;
+        stdex::bounded_channel<std::uint64_t> channel(1024);
+        std::atomic<std::size_t> senders_left = { producers };
+        std::atomic<std::size_t> running = { producers + consumers };
+        auto finish = [](std::atomic<std::size_t>& running) {
+            if (running.fetch_sub(1) == 1)
+                running.notify_all();
+        };
+        auto begin = bench::clock::now();
+        for (std::size_t c = 0; c < consumers; c++)
+            stdex::spawn(pool, [](stdex::bounded_channel<std::uint64_t>& channel, auto& pool, auto finish, std::atomic<std::size_t>& running) -> stdex::task<> {
+                std::uint64_t value;
+                while (co_await channel.recv_async(value, pool) == stdex::channel_status::ok)
+                    ;
+                finish(running);
+            }(channel, pool, finish, running));
+        for (std::size_t p = 0; p < producers; p++)
+            stdex::spawn(pool, [](stdex::bounded_channel<std::uint64_t>& channel, auto& pool, std::size_t count, auto finish, std::atomic<std::size_t>& senders_left,
+                                  std::atomic<std::size_t>& running) -> stdex::task<> {
+                for (std::uint64_t i = 0; i < count; i++)
+                    co_await channel.send_async(i, pool);
+                if (senders_left.fetch_sub(1) == 1)
+                    channel.close();
+                finish(running);
+            }(channel, pool, count, finish, senders_left, running));
+        for (auto left = running.load(); left != 0; left = running.load())
+            running.wait(left);
+        auto seconds = std::chrono::duration<double>(bench::clock::now() - begin).count();
+        out.add({ "channel",
+                  "bounded mpmc coroutines",
+                  { { "producers", static_cast<std::int64_t>(producers) }, { "consumers", static_cast<std::int64_t>(consumers) } },
+                  { { "messages_per_s", static_cast<double>(producers * count) / seconds } } });
+    }
+
+    // three stages on the default pool fed from this thread, batch is the items a stage worker takes per wakeup
+    void pipeline(bench::report& out, std::size_t parallelism, std::size_t batch, std::size_t count)
+    {
+        std::atomic<std::uint64_t> sum = { 0 };
+        stdex::stage_options options = { .parallelism = parallelism, .batch = batch };
+        auto begin = bench::clock::now();
+        {
+            auto p = stdex::pipeline_builder<std::uint64_t>(stdex::detail::default_pool)
+                         .stage("scale", [](std::uint64_t v) { return v * 3; }, options)
+                         .stage("mix", [](std::uint64_t v) { return v ^ (v >> 7); }, options)
+                         .sink("sum", [&sum](std::uint64_t v) { sum.fetch_add(v, std::memory_order_relaxed); }, options);
+            for (std::uint64_t i = 0; i < count; i++)
+                p.push(i);
+            p.close();
+            p.wait();
+        }
+        auto seconds = std::chrono::duration<double>(bench::clock::now() - begin).count();
+        out.add({ "channel",
+                  "pipeline 3 stages",
+                  { { "parallelism", static_cast<std::int64_t>(parallelism) }, { "batch", static_cast<std::int64_t>(batch) } },
+                  { { "messages_per_s", static_cast<double>(count) / seconds } } });
+        if (sum == 0)
+            out.fail("pipeline summed nothing");
+    }
+
+    // the latest-value mailbox: set on one side, ref polls on the other
+    void mailbox(bench::report& out, std::size_t iterations)
+    {
+        stdex::channel<std::uint64_t> channel;
+        auto input = channel.get_input();
+        auto set = bench::ns_per_op(iterations, [&](std::size_t i) { input.set(i); });
+        std::uint64_t sum = 0;
+        auto ref = bench::ns_per_op(iterations, [&](std::size_t) { sum += channel.ref(); });
+        out.add({ "channel", "channel<T> mailbox", {}, { { "set_ns", set }, { "ref_ns", ref } } });
+        if (sum == 0)
+            out.fail("mailbox read nothing");
+    }
+} // namespace
+
+void bench::run_channel(report& out, const options& opts)
+{
+    auto count = opts.scale(1000000);
+    {
+        stdex::bounded_channel<std::uint64_t, stdex::channel_kind::spsc> channel(1024);
+        throughput(out, "bounded spsc", 1, 1, count, channel);
+    }
+    {
+        stdex::bounded_channel<std::uint64_t, stdex::channel_kind::mpsc> channel(1024);
+        throughput(out, "bounded mpsc", 4, 1, count / 4, channel);
+    }
+    for (auto [producers, consumers] : { std::pair<std::size_t, std::size_t>{ 1, 1 }, { 4, 4 } })
+    {
+        stdex::bounded_channel<std::uint64_t> channel(1024);
+        throughput(out, "bounded mpmc", producers, consumers, count / producers, channel);
+    }
+    {
+        stdex::unbounded_channel<std::uint64_t> channel;
+        throughput(out, "unbounded", 4, 4, count / 4, channel);
+    }
+    coroutines(out, 64, 64, count / 64);
+    batched(out, count);
+    for (std::size_t batch : { 1, 16 })
+        for (std::size_t parallelism : { 1, 4 })
+            pipeline(out, parallelism, batch, count);
+    ping_pong(out, opts.scale(100000), stdex::bounded_channel<std::uint64_t>::default_spin_count);
+    ping_pong(out, opts.scale(20000), 0);
+    mailbox(out, opts.scale(1000000));
+}
@@ -0,0 +1,130 @@
+#include "bench.hpp"
+
+#include <concurrent_unordered_map.hpp>
+#include <concurrent_vector.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    // the wrapping the request came from: every read takes the shared lock, every write the exclusive one
+    class locked_map
+    {
+        std::unordered_map<std::uint64_t, std::uint64_t> map;
+        mutable std::shared_mutex mutex;
+
+    public:
+        std::optional<std::uint64_t> get(std::uint64_t key) const
+        {
+            std::shared_lock lock(mutex);
+            auto found = map.find(key);
+            if (found == map.end())
+                return std::nullopt;
+            return found->second;
+        }
+        void insert_or_assign(std::uint64_t key, std::uint64_t value)
+        {
+            std::unique_lock lock(mutex);
+            map.insert_or_assign(key, value);
+        }
+    };
+
+    class locked_vector
+    {
+        std::vector<std::uint64_t> items;
+        std::mutex mutex;
+
+    public:
+        void push_back(std::uint64_t value)
+        {
+            std::lock_guard lock(mutex);
+            items.push_back(value);
+        }
+    };
+
+    // threads mix reads and writes over a prefilled key range for a fixed time, writes_per_mille of every thousand ops write
+    template <typename Map>
+    void map_mix(bench::report& out, const bench::options& opts, const char* name, Map& map, std::size_t threads, std::size_t keys, std::size_t writes_per_mille)
+    {
+        for (std::uint64_t key = 0; key < keys; key++)
+            map.insert_or_assign(key, key);
+        std::atomic<bool> running = { true };
+        std::atomic<std::uint64_t> ops = { 0 };
+        {
+            std::vector<std::jthread> workers;
+            for (std::size_t t = 0; t < threads; t++)
+                workers.emplace_back([&, t] {
+                    std::uint64_t count = 0;
+                    std::uint64_t hits = 0;
+                    auto key = t * 7919;
+                    while (running.load(std::memory_order_relaxed))
+                    {
+                        key = (key * 6364136223846793005ull + 1442695040888963407ull);
+                        auto slot = (key >> 33) % keys;
+                        if ((key >> 13) % 1000 < writes_per_mille)
+                            map.insert_or_assign(slot, count);
+                        else
+                            hits += map.get(slot).has_value();
+                        count++;
+                    }
+                    ops += count;
+                    if (hits == 0 && writes_per_mille < 1000)
+                        out.fail("{} read nothing", name);
+                });
+            std::this_thread::sleep_for(opts.run_time());
+            running = false;
+        }
+        auto seconds = std::chrono::duration<double>(opts.run_time()).count();
+        out.add({ "containers",
+                  name,
+                  { { "threads", static_cast<std::int64_t>(threads) }, { "keys", static_cast<std::int64_t>(keys) }, { "writes_per_mille", static_cast<std::int64_t>(writes_per_mille) } },
+                  { { "ops_per_s", static_cast<double>(ops) / seconds } } });
+    }
+
+    template <typename Vector> void append(bench::report& out, const char* name, std::size_t threads, std::size_t count)
+    {
+        Vector vector;
+        auto begin = bench::clock::now();
+        {
+            std::vector<std::jthread> workers;
+            for (std::size_t t = 0; t < threads; t++)
+                workers.emplace_back([&] {
+                    for (std::uint64_t i = 0; i < count; i++)
+                        vector.push_back(i);
+                });
+        }
+        auto seconds = std::chrono::duration<double>(bench::clock::now() - begin).count();
+        out.add({ "containers", name, { { "threads", static_cast<std::int64_t>(threads) } }, { { "push_backs_per_s", static_cast<double>(threads * count) / seconds } } });
+    }
+} // namespace
+
+void bench::run_containers(report& out, const options& opts)
+{
+    constexpr std::size_t keys = 100000;
+    for (std::size_t threads : { 1, 4 })
+        for (std::size_t writes : { 10, 100, 500 })
+        {
+            {
+                locked_map map;
+                map_mix(out, opts, "unordered_map + shared_mutex", map, threads, keys, writes);
+            }
+            {
+                stdex::concurrent_unordered_map<std::uint64_t, std::uint64_t> map;
+                map_mix(out, opts, "concurrent_unordered_map", map, threads, keys, writes);
+            }
+        }
+
+    auto count = opts.scale(1000000);
+    for (std::size_t threads : { 1, 4 })
+    {
+        append<locked_vector>(out, "vector + mutex push_back", threads, count / threads);
+        append<stdex::concurrent_vector<std::uint64_t>>(out, "concurrent_vector push_back", threads, count / threads);
+    }
+}
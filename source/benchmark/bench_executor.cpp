@@ -0,0 +1,36 @@
+#include "bench.hpp"
+
+#include <single_async_executor.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+namespace
+{
+    // submissions that land while a long job holds the executor, they never reach the pool
+    void overlapping(bench::report& out, stdex::overlap_policy policy, const char* name, std::size_t count)
+    {
+        stdex::single_async_executor<int> executor(policy);
+        std::atomic<bool> release = { false };
+        executor.submit([&release] {
+            while (!release.load())
+                std::this_thread::yield();
+            return 0;
+        });
+        auto submit = bench::ns_per_op(count, [&](std::size_t i) { executor.submit([i] { return static_cast<int>(i); }); });
+        release = true;
+        executor.wait();
+        out.add({ "executor", name, {}, { { "submit_ns", submit } } });
+    }
+} // namespace
+
+void bench::run_executor(report& out, const options& opts)
+{
+    auto count = opts.scale(200000);
+    overlapping(out, stdex::overlap_policy::reject, "submit while busy, reject", count);
+    overlapping(out, stdex::overlap_policy::coalesce, "submit while busy, coalesce", count);
+
+    stdex::single_async_executor<int> executor;
+    auto round_trip = bench::ns_per_op(opts.scale(20000), [&](std::size_t i) { executor.submit([i] { return static_cast<int>(i); }).future.wait(); });
+    out.add({ "executor", "submit and wait on idle executor", {}, { { "round_trip_ns", round_trip } } });
+}
@@ -0,0 +1,90 @@
+#include "bench.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <string_view>
+#include <thread>
+
+#ifndef STDEX_BENCH_VERSION
+    #define STDEX_BENCH_VERSION "unknown"
+#endif
+
+namespace
+{
+    std::string json_escape(std::string_view text)
+    {
+        std::string escaped;
+        for (auto c : text)
+        {
+            if (c == '"' || c == '\\')
+                escaped += '\\';
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    // flat schema so runs of different versions can be diffed by (suite, name, params)
+    bool write_json(const bench::report& out, const bench::options& opts)
+    {
+        auto file = std::fopen(opts.json_path.c_str(), "w");
+        if (file == nullptr)
+            return false;
+        fmt::print(file, "{{\n  \"version\": \"{}\",\n  \"timestamp\": {},\n  \"hardware_concurrency\": {},\n  \"quick\": {},\n  \"results\": [",
+                   STDEX_BENCH_VERSION, static_cast<long long>(std::time(nullptr)), std::thread::hardware_concurrency(), opts.quick);
+        bool first = true;
+        for (auto& entry : out.entries())
+        {
+            fmt::print(file, "{}\n    {{ \"suite\": \"{}\", \"name\": \"{}\", \"params\": {{", first ? "" : ",", json_escape(entry.suite), json_escape(entry.name));
+            for (std::size_t i = 0; i < entry.params.size(); i++)
+                fmt::print(file, "{}\"{}\": {}", i == 0 ? " " : ", ", json_escape(entry.params[i].first), entry.params[i].second);
+            fmt::print(file, " }}, \"metrics\": {{");
+            for (std::size_t i = 0; i < entry.metrics.size(); i++)
+                fmt::print(file, "{}\"{}\": {:.3f}", i == 0 ? " " : ", ", json_escape(entry.metrics[i].first), entry.metrics[i].second);
+            fmt::print(file, " }} }}");
+            first = false;
+        }
+        fmt::print(file, "\n  ]\n}}\n");
+        std::fclose(file);
+        return true;
+    }
+} // namespace
+
+// usage: std-parallel-container-ex.bench [--quick] [--filter <suite>] [--json <path>]
+int main(int argc, char* argv[])
+{
+    bench::options opts;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string_view arg = argv[i];
+        if (arg == "--quick")
+            opts.quick = true;
+        else if (arg == "--filter" && i + 1 < argc)
+            opts.filter = argv[++i];
+        else if (arg == "--json" && i + 1 < argc)
+            opts.json_path = argv[++i];
+        else
+        {
+            fmt::print(stderr, "usage: {} [--quick] [--filter <suite>] [--json <path>]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    constexpr std::pair<std::string_view, void (*)(bench::report&, const bench::options&)> suites[] = {
+        { "registry", bench::run_registry }, { "syncer", bench::run_syncer }, { "channel", bench::run_channel },        { "pool", bench::run_async_pool },
+        { "timer", bench::run_timer },       { "executor", bench::run_executor }, { "algorithm", bench::run_algorithm }, { "containers", bench::run_containers },
+    };
+
+    bench::report out;
+    for (auto& [name, run] : suites)
+        if (name.find(opts.filter) != std::string_view::npos)
+            run(out, opts);
+
+    if (!write_json(out, opts))
+    {
+        fmt::print(stderr, "cannot write {}\n", opts.json_path);
+        return 1;
+    }
+    fmt::print("wrote {} results to {}\n", out.entries().size(), opts.json_path);
+    return out.failed() ? 1 : 0;
+}
@@ -0,0 +1,83 @@
+#include "bench.hpp"
+
+#include <task_registry.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct bench_task : stdex::detail::registry_hook
+    {
+        stdex::task_id id;
+        std::shared_ptr<stdex::detail::task_name> name_owner;
+    };
+
+    // the registry layout before sharding: one ordered map scanned by name
+    struct map_task
+    {
+        std::string name;
+        stdex::task_id id;
+    };
+} // namespace
+
+void bench::run_registry(report& out, const options& opts)
+{
+    constexpr std::size_t name_count = 64;
+    auto iterations = opts.scale(200000);
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < name_count; i++)
+        names.push_back(fmt::format("task.{}", i));
+
+    for (std::size_t size : { 10, 100, 1000, 10000, 100000 })
+    {
+        std::map<stdex::task_id, map_task> map;
+        stdex::detail::task_registry<bench_task> registry;
+        for (std::size_t i = 0; i < size; i++)
+        {
+            auto id = static_cast<stdex::task_id>(i + 1);
+            map[id] = { names[i % name_count], id };
+
+            auto task = std::make_shared<bench_task>();
+            task->id = id;
+            task->name_owner = registry.intern(names[i % name_count]);
+            task->name_entry = task->name_owner.get();
+            registry.insert(std::move(task));
+        }
+
+        // look up names that are absent as often as present ones, like a dedupe check would
+        std::size_t hits = 0;
+        std::size_t map_iterations = std::max<std::size_t>(iterations / size, 100);
+        auto map_has = ns_per_op(map_iterations, [&](std::size_t i) {
+            const auto& name = names[(i * 7) % name_count];
+            for (auto& [_, task] : map)
+                if (task.name == name)
+                {
+                    hits++;
+                    break;
+                }
+        });
+        auto registry_has = ns_per_op(iterations, [&](std::size_t i) { hits += registry.count(names[(i * 7) % name_count]) != 0; });
+        auto map_id = ns_per_op(iterations, [&](std::size_t i) { hits += map.contains(static_cast<stdex::task_id>(i % size + 1)); });
+        auto registry_id = ns_per_op(iterations, [&](std::size_t i) { hits += registry.find(static_cast<stdex::task_id>(i % size + 1)) != nullptr; });
+        // names() walks every member of one name, so it grows with size / name_count
+        auto registry_names = ns_per_op(std::max<std::size_t>(iterations / std::max<std::size_t>(size / name_count, 1), 100), [&](std::size_t i) {
+            registry.for_each(names[i % name_count], [&](const bench_task&) { hits++; });
+        });
+
+        out.add({ "registry",
+                  "lookup",
+                  { { "tasks", static_cast<std::int64_t>(size) } },
+                  { { "map_has_ns", map_has },
+                    { "has_ns", registry_has },
+                    { "map_id_ns", map_id },
+                    { "id_ns", registry_id },
+                    { "names_ns", registry_names } } });
+        if (hits == 0)
+            out.fail("registry lookups found nothing");
+    }
+}
@@ -0,0 +1,150 @@
+#include "bench.hpp"
+
+#include <syncer.hpp>
+#include <syncer_table.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct frame
+    {
+        std::array<std::int64_t, 512> values = {};
+    };
+
+    // writers and readers hammer one syncer for a fixed time, read returns whether it saw a new value
+    template <typename Write, typename Read>
+    void contend(bench::report& out, const bench::options& opts, const char* name, std::size_t bytes, std::size_t writers, std::size_t readers, Write write, Read read)
+    {
+        std::atomic<bool> running = { true };
+        std::atomic<std::uint64_t> writes = { 0 };
+        std::atomic<std::uint64_t> reads = { 0 };
+        std::atomic<std::uint64_t> fresh = { 0 };
+        {
+            std::vector<std::jthread> threads;
+            for (std::size_t w = 0; w < writers; w++)
+                threads.emplace_back([&] {
+                    std::uint64_t count = 0;
+                    while (running.load(std::memory_order_relaxed))
+                        write(count++);
+                    writes += count;
+                });
+            for (std::size_t r = 0; r < readers; r++)
+                threads.emplace_back([&, reader = read()]() mutable {
+                    std::uint64_t count = 0;
+                    std::uint64_t changed = 0;
+                    while (running.load(std::memory_order_relaxed))
+                    {
+                        changed += reader();
+                        count++;
+                    }
+                    reads += count;
+                    fresh += changed;
+                });
+            std::this_thread::sleep_for(opts.run_time());
+            running = false;
+        }
+        auto seconds = std::chrono::duration<double>(opts.run_time()).count();
+        out.add({ "syncer",
+                  name,
+                  { { "bytes", static_cast<std::int64_t>(bytes) }, { "writers", static_cast<std::int64_t>(writers) }, { "readers", static_cast<std::int64_t>(readers) } },
+                  { { "writes_per_s", static_cast<double>(writes) / seconds },
+                    { "reads_per_s", static_cast<double>(reads) / seconds },
+                    { "fresh_reads_per_s", static_cast<double>(fresh) / seconds } } });
+    }
+
+    template <typename T> T make_value(std::uint64_t i)
+    {
+        if constexpr (std::is_same_v<T, frame>)
+        {
+            T value;
+            value.values[0] = static_cast<std::int64_t>(i);
+            return value;
+        }
+        else
+            return static_cast<T>(i);
+    }
+
+    template <typename T> void run_payload(bench::report& out, const bench::options& opts)
+    {
+        constexpr std::pair<std::size_t, std::size_t> shapes[] = { { 1, 1 }, { 1, 4 }, { 4, 1 }, { 4, 4 } };
+        for (auto [writers, readers] : shapes)
+        {
+            stdex::syncer<T> syncer;
+            contend(out, opts, "syncer<T, false>", sizeof(T), writers, readers, [&](std::uint64_t i) { syncer.set(make_value<T>(i)); }, [&] {
+                return [&syncer, value = T{}]() mutable { return syncer.try_sync(value); };
+            });
+        }
+        for (auto [writers, readers] : shapes)
+        {
+            stdex::syncer<T, true> syncer;
+            contend(out, opts, "syncer<T, true>", sizeof(T), writers, readers, [&](std::uint64_t i) { syncer.set(make_value<T>(i)); }, [&] {
+                return [&syncer, value = T{}]() mutable { return syncer.try_sync(value); };
+            });
+        }
+        // single consumer by design, only the writer side scales
+        for (std::size_t writers : { 1, 4 })
+        {
+            stdex::triple_buffer_syncer<T> syncer;
+            contend(out, opts, "triple_buffer_syncer", sizeof(T), writers, 1, [&](std::uint64_t i) { syncer.set(make_value<T>(i)); }, [&] {
+                return [&syncer, value = T{}]() mutable { return syncer.try_sync(value); };
+            });
+        }
+        for (std::size_t readers : { 1, 2, 4, 8 })
+        {
+            stdex::versioned_syncer<T> syncer;
+            contend(out, opts, "versioned_syncer view", sizeof(T), 1, readers, [&](std::uint64_t i) { syncer.set(make_value<T>(i)); }, [&] {
+                return [reader = syncer.make_reader()]() mutable { return reader.try_view().has_value(); };
+            });
+        }
+        for (std::size_t readers : { 1, 2, 4, 8 })
+        {
+            stdex::snapshot_syncer<T> syncer;
+            contend(out, opts, "snapshot_syncer", sizeof(T), 1, readers, [&](std::uint64_t i) { syncer.set(make_value<T>(i)); }, [&] {
+                return [reader = syncer.make_reader()]() mutable { return reader.try_snapshot() != nullptr; };
+            });
+        }
+    }
+
+    // one consumer ticking over a table of values while writers update a few slots, a read is a full tick
+    void run_table(bench::report& out, const bench::options& opts)
+    {
+        static constexpr std::size_t slots = 4096;
+        auto slot_of = [](std::uint64_t i) { return static_cast<std::size_t>(i * 97) % slots; };
+        for (std::size_t writers : { 1, 4 })
+        {
+            std::vector<stdex::syncer<std::int64_t, true>> syncers(slots);
+            contend(out, opts, "syncer<T, true> x4096 tick", sizeof(std::int64_t), writers, 1, [&](std::uint64_t i) {
+                syncers[slot_of(i)].set(static_cast<std::int64_t>(i));
+            }, [&] {
+                return [&syncers, values = std::vector<std::int64_t>(slots)]() mutable {
+                    std::size_t changed = 0;
+                    for (std::size_t s = 0; s < slots; s++)
+                        changed += syncers[s].try_sync(values[s]);
+                    return changed;
+                };
+            });
+        }
+        for (std::size_t writers : { 1, 4 })
+        {
+            stdex::syncer_table<std::int64_t> table(slots);
+            contend(out, opts, "syncer_table x4096 tick", sizeof(std::int64_t), writers, 1, [&](std::uint64_t i) {
+                table.set(slot_of(i), static_cast<std::int64_t>(i));
+            }, [&] {
+                return [&table, values = std::vector<std::int64_t>(slots)]() mutable { return table.try_sync(std::span(values)); };
+            });
+        }
+    }
+} // namespace
+
+void bench::run_syncer(report& out, const options& opts)
+{
+    run_payload<std::int64_t>(out, opts);
+    run_payload<frame>(out, opts);
+    run_table(out, opts);
+}
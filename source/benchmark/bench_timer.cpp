@@ -0,0 +1,35 @@
+#include "bench.hpp"
+
+#include <self_releasing_async.hpp>
+
+#include <thread>
+
+namespace
+{
+    // lateness of every tick against its schedule, as recorded by the pool itself
+    template <typename Start> void jitter(bench::report& out, const char* name, std::size_t ticks, Start&& start)
+    {
+        constexpr auto interval = std::chrono::milliseconds(1);
+        stdex::detail::async_pool pool;
+        auto id = start(pool, interval);
+        std::this_thread::sleep_for(interval * ticks);
+        auto stats = pool.jitter(id).value_or(stdex::jitter_stats{});
+        pool.stop_forever(id);
+        pool.wait(id);
+        out.add({ "timer",
+                  name,
+                  { { "interval_us", 1000 } },
+                  { { "ticks", static_cast<double>(stats.ticks) },
+                    { "p50_ns", static_cast<double>(stats.p50.count()) },
+                    { "p99_ns", static_cast<double>(stats.p99.count()) },
+                    { "max_ns", static_cast<double>(stats.max.count()) } } });
+    }
+} // namespace
+
+void bench::run_timer(report& out, const options& opts)
+{
+    auto ticks = opts.scale(2000);
+    jitter(out, "start_forever", ticks, [](auto& pool, auto interval) { return pool.start_forever("bench.timer", interval, [] {}); });
+    jitter(out, "start_forever_high_resolution", ticks, [](auto& pool, auto interval) { return pool.start_forever_high_resolution("bench.timer", interval, [] {}); });
+    jitter(out, "start_forever_system_perf", ticks, [](auto& pool, auto interval) { return pool.start_forever_system_perf("bench.timer", interval, [] {}); });
+}
@@ -0,0 +1,350 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__)
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <time.h>
+    #include <unistd.h>
+#elif defined(_WIN32) || defined(_WIN64)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+    #undef NOMINMAX
+    #undef WIN32_LEAN_AND_MEAN
+    #if defined(_MSC_VER)
+        #pragma comment(lib, "Synchronization.lib")
+    #endif
+#endif
+
+namespace stdex
+{
+    namespace detail
+    {
+        // std::atomic::wait has no timed form, these wrap the platform futex directly.
+        // waits and notifies on a word must all go through these helpers, never mixed with std::atomic::notify_*.
+        using wait_clock = std::chrono::steady_clock;
+
+        inline void cpu_relax() noexcept
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__)
+            asm volatile("yield");
+#elif defined(_WIN32) || defined(_WIN64)
+            YieldProcessor();
+#endif
+        }
+
+        inline void atomic_wait(std::atomic<std::uint32_t>& word, std::uint32_t old) noexcept
+        {
+#if defined(__linux__)
+            while (word.load(std::memory_order_acquire) == old)
+                ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE, old, nullptr, nullptr, 0);
+#elif defined(_WIN32) || defined(_WIN64)
+            while (word.load(std::memory_order_acquire) == old)
+                ::WaitOnAddress(&word, &old, sizeof(old), INFINITE);
+#else
+            word.wait(old, std::memory_order_acquire);
+#endif
+        }
+
+        // false when the deadline passed with the word still holding old
+        inline bool atomic_wait_until(std::atomic<std::uint32_t>& word, std::uint32_t old, wait_clock::time_point deadline) noexcept
+        {
+            while (word.load(std::memory_order_acquire) == old)
+            {
+                auto now = wait_clock::now();
+                if (now >= deadline)
+                    return false;
+#if defined(__linux__)
+                // FUTEX_WAIT_BITSET takes an absolute CLOCK_MONOTONIC deadline, the clock behind steady_clock
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+                timespec ts = { static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000) };
+                ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT_BITSET_PRIVATE, old, &ts, nullptr, FUTEX_BITSET_MATCH_ANY);
+#elif defined(_WIN32) || defined(_WIN64)
+                auto ms = std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count();
+                ::WaitOnAddress(&word, &old, sizeof(old), static_cast<DWORD>(ms));
+#else
+                std::this_thread::sleep_for(std::min<wait_clock::duration>(deadline - now, std::chrono::milliseconds(1)));
+#endif
+            }
+            return true;
+        }
+
+        inline void atomic_notify_one(std::atomic<std::uint32_t>& word) noexcept
+        {
+#if defined(__linux__)
+            ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#elif defined(_WIN32) || defined(_WIN64)
+            ::WakeByAddressSingle(&word);
+#else
+            word.notify_one();
+#endif
+        }
+        inline void atomic_notify_all(std::atomic<std::uint32_t>& word) noexcept
+        {
+#if defined(__linux__)
+            ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+#elif defined(_WIN32) || defined(_WIN64)
+            ::WakeByAddressAll(&word);
+#else
+            word.notify_all();
+#endif
+        }
+
+        // a suspended coroutine queued on a wait_event. shared by its awaiter, the event's list and wakes on their
+        // way; the awaiter clears owner when it goes, so a wake that comes late finds nothing to resume
+        struct async_waiter
+        {
+            async_waiter* next = nullptr;
+            std::shared_ptr<async_waiter> queued; // the event's reference while linked
+            void (*wake)(const std::shared_ptr<async_waiter>&) = nullptr; // runs on the notifying thread and must only hand it off
+            void* scheduler = nullptr;
+            std::mutex mutex;
+            void* owner = nullptr; // guarded by mutex
+        };
+
+        // eventcount: notify is a fence and a load unless somebody is parked.
+        // a waiter calls prepare_wait, rechecks its condition, then commits with wait / wait_until / wait_async or calls cancel_wait.
+        class wait_event
+        {
+            std::atomic<std::uint32_t> epoch = { 0 };
+            std::atomic<std::uint32_t> waiters = { 0 };
+            std::atomic<std::uint32_t> async_count = { 0 };
+            std::mutex async_mutex;
+            async_waiter* async_head = nullptr;
+
+        private:
+            void wake_async(bool all) noexcept
+            {
+                async_waiter* woken = nullptr;
+                {
+                    std::lock_guard lock(async_mutex);
+                    if (async_head == nullptr)
+                        return;
+                    woken = async_head;
+                    std::uint32_t count = 1;
+                    if (all)
+                    {
+                        async_head = nullptr;
+                        for (auto waiter = woken; waiter->next != nullptr; waiter = waiter->next)
+                            count++;
+                    }
+                    else
+                    {
+                        async_head = woken->next;
+                        woken->next = nullptr;
+                    }
+                    async_count.fetch_sub(count, std::memory_order_relaxed);
+                    waiters.fetch_sub(count, std::memory_order_relaxed);
+                }
+                // the list's reference keeps each one alive until its wake took over, then it may be requeued
+                while (woken != nullptr)
+                {
+                    auto next = woken->next;
+                    auto waiter = std::move(woken->queued);
+                    waiter->wake(waiter);
+                    woken = next;
+                }
+            }
+            void notify(bool all) noexcept
+            {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (waiters.load(std::memory_order_relaxed) == 0)
+                    return;
+                epoch.fetch_add(1, std::memory_order_seq_cst);
+                if (all)
+                    atomic_notify_all(epoch);
+                else
+                    atomic_notify_one(epoch);
+                if (async_count.load(std::memory_order_seq_cst) != 0)
+                    wake_async(all);
+            }
+
+        public:
+            std::uint32_t prepare_wait() noexcept
+            {
+                waiters.fetch_add(1, std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                return epoch.load(std::memory_order_acquire);
+            }
+            void cancel_wait() noexcept { waiters.fetch_sub(1, std::memory_order_relaxed); }
+            void wait(std::uint32_t key) noexcept
+            {
+                atomic_wait(epoch, key);
+                waiters.fetch_sub(1, std::memory_order_relaxed);
+            }
+            bool wait_until(std::uint32_t key, wait_clock::time_point deadline) noexcept
+            {
+                auto woken = atomic_wait_until(epoch, key, deadline);
+                waiters.fetch_sub(1, std::memory_order_relaxed);
+                return woken;
+            }
+            // queues waiter instead of blocking, false when a notify already came after prepare_wait and
+            // the condition should be rechecked. once queued, waiter.wake is called by the next notify.
+            bool wait_async(std::uint32_t key, const std::shared_ptr<async_waiter>& waiter) noexcept
+            {
+                async_count.fetch_add(1, std::memory_order_seq_cst);
+                std::lock_guard lock(async_mutex);
+                if (epoch.load(std::memory_order_seq_cst) != key)
+                {
+                    async_count.fetch_sub(1, std::memory_order_relaxed);
+                    waiters.fetch_sub(1, std::memory_order_relaxed);
+                    return false;
+                }
+                waiter->next = async_head;
+                waiter->queued = waiter;
+                async_head = waiter.get();
+                return true;
+            }
+            // takes waiter off the list if no notify took it yet, for an awaiter destroyed while suspended
+            void cancel_async(async_waiter& waiter) noexcept
+            {
+                std::shared_ptr<async_waiter> unlinked; // dropped after the lock, the awaiter still holds waiter
+                std::lock_guard lock(async_mutex);
+                for (auto link = &async_head; *link != nullptr; link = &(*link)->next)
+                {
+                    if (*link != &waiter)
+                        continue;
+                    *link = waiter.next;
+                    waiter.next = nullptr;
+                    unlinked = std::move(waiter.queued);
+                    async_count.fetch_sub(1, std::memory_order_relaxed);
+                    waiters.fetch_sub(1, std::memory_order_relaxed);
+                    break;
+                }
+            }
+
+            // spins on ready up to spin_count times, then parks until ready holds, st is stopped or the
+            // deadline passes. ready is rechecked after every wake and must be safe to call repeatedly.
+            template <typename Ready>
+            bool await(Ready&& ready, std::uint32_t spin_count, std::stop_token st = {}, const wait_clock::time_point* deadline = nullptr)
+            {
+                for (std::uint32_t i = 0; i < spin_count; i++)
+                {
+                    if (ready())
+                        return true;
+                    if (st.stop_requested())
+                        return false;
+                    cpu_relax();
+                }
+
+                auto wake_all = [this] { notify_all(); };
+                std::optional<std::stop_callback<decltype(wake_all)>> on_stop;
+                if (st.stop_possible())
+                    on_stop.emplace(st, wake_all);
+                for (;;)
+                {
+                    auto key = prepare_wait();
+                    if (ready())
+                    {
+                        cancel_wait();
+                        return true;
+                    }
+                    if (st.stop_requested())
+                    {
+                        cancel_wait();
+                        return false;
+                    }
+                    if (deadline == nullptr)
+                        wait(key);
+                    else if (!wait_until(key, *deadline))
+                        return ready();
+                }
+            }
+
+            // notify_one wakes at most one blocked thread and one queued coroutine
+            void notify_one() noexcept { notify(false); }
+            void notify_all() noexcept { notify(true); }
+        };
+
+        // co_await side of wait_event: attempt() returns an engaged optional once the operation went through.
+        // until then the coroutine is queued on the event and every wake retries it on the scheduler, so nothing
+        // blocks a thread. Scheduler only needs post(callable). destroying the suspended coroutine takes it off
+        // the event, a wake already posted for it does nothing
+        template <typename Scheduler, typename Attempt> class event_awaiter
+        {
+            using result_type = typename std::invoke_result_t<Attempt&>::value_type;
+
+            wait_event& event;
+            Scheduler& scheduler;
+            Attempt attempt;
+            std::optional<result_type> result;
+            std::coroutine_handle<> handle;
+            std::shared_ptr<async_waiter> waiter; // made on the first suspension
+
+            // true once the attempt went through, false when queued
+            bool settle()
+            {
+                for (;;)
+                {
+                    auto key = event.prepare_wait();
+                    if ((result = attempt()))
+                    {
+                        event.cancel_wait();
+                        return true;
+                    }
+                    if (event.wait_async(key, waiter))
+                        return false;
+                }
+            }
+            // retried under the waiter's mutex, so the awaiter cannot go while the attempt runs
+            static void on_wake(const std::shared_ptr<async_waiter>& waiter)
+            {
+                static_cast<Scheduler*>(waiter->scheduler)->post([waiter] {
+                    std::coroutine_handle<> resume;
+                    {
+                        std::lock_guard lock(waiter->mutex);
+                        auto self = static_cast<event_awaiter*>(waiter->owner);
+                        if (self == nullptr || !self->settle())
+                            return;
+                        resume = self->handle;
+                    }
+                    resume.resume();
+                });
+            }
+
+        public:
+            event_awaiter(wait_event& event, Scheduler& scheduler, Attempt attempt) : event(event), scheduler(scheduler), attempt(std::move(attempt)) {}
+            event_awaiter(event_awaiter&&) = default;
+            ~event_awaiter()
+            {
+                if (waiter == nullptr)
+                    return;
+                {
+                    std::lock_guard lock(waiter->mutex);
+                    waiter->owner = nullptr;
+                }
+                event.cancel_async(*waiter);
+            }
+
+            bool await_ready() { return (result = attempt()).has_value(); }
+            // the awaiter may be resumed on another thread before this returns, nothing is touched after queuing
+            bool await_suspend(std::coroutine_handle<> awaiting)
+            {
+                handle = awaiting;
+                if (waiter == nullptr)
+                {
+                    waiter = std::make_shared<async_waiter>();
+                    waiter->wake = &on_wake;
+                    waiter->scheduler = std::addressof(scheduler);
+                    waiter->owner = this;
+                }
+                return !settle();
+            }
+            result_type await_resume() { return std::move(*result); }
+        };
+    } // namespace detail
+} // namespace stdex
@@ -1,14 +1,28 @@
 #pragma once
+#include <algorithm>
 #include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <memory>
 #include <mutex>
+#include <new>
+#include <optional>
+#include <stop_token>
+#include <type_traits>
+#include <utility>
 
+#include <atomic_wait.hpp>
 #include <syncer.hpp>
 
 namespace stdex
 {
     template <typename T> class channel
     {
-        using syncer_t = stdex::syncer<T, true>;
+        using syncer_t = stdex::triple_buffer_syncer<T>;
 
     public:
         class inlet
@@ -17,7 +31,8 @@ namespace stdex
 
         public:
             inlet(syncer_t& syncer) : source(syncer) {}
-            void set(const T& value) noexcept { source.set(value); }
+            void set(const T& value) { source.set(value); }
+            void set(T&& value) { source.set(std::move(value)); }
         };
 
     private:
@@ -31,6 +46,12 @@ namespace stdex
             syncer.try_sync(value);
             return value;
         }
+        // like ref, but parks until a value newer than the last one arrives or st is stopped
+        T& wait_ref(std::stop_token st = {})
+        {
+            syncer.wait_sync(value, st);
+            return value;
+        }
     };
 
     template <typename T> class channel_accessor
@@ -41,4 +62,441 @@ namespace stdex
         channel_accessor(channel<T>& channel) : value(channel.ref()) {}
         operator T&() { return value; }
     };
-} // namespace stdex
\ No newline at end of file
+
+    // who may call send and recv concurrently on a bounded_channel
+    enum class channel_kind
+    {
+        spsc, // one sender thread, one receiver thread
+        mpsc, // any senders, one receiver thread
+        mpmc, // any senders, any receivers
+    };
+
+    enum class channel_status
+    {
+        ok,
+        empty,   // try_recv found nothing
+        full,    // try_send found no free slot
+        closed,  // closed, and for receives also drained
+        timeout, // recv_for / recv_until ran out of time
+        stopped, // the stop_token passed to a blocking call was triggered
+    };
+
+    namespace detail
+    {
+        inline constexpr std::size_t cache_line = 64;
+
+        template <typename T> class ring_slot
+        {
+            alignas(T) std::byte storage[sizeof(T)];
+
+        public:
+            template <typename... Args> void construct(Args&&... args) { ::new (static_cast<void*>(storage)) T(std::forward<Args>(args)...); }
+            T& get() noexcept { return *std::launder(reinterpret_cast<T*>(storage)); }
+            void take(T& out)
+            {
+                out = std::move(get());
+                get().~T();
+            }
+        };
+
+        // fixed power-of-two ring. mpmc and mpsc use per-slot sequence numbers (vyukov), spsc is a plain
+        // lamport queue where each side caches the other side's index to stay off its cache line.
+        template <typename T, channel_kind kind> class channel_ring
+        {
+            static constexpr bool sequenced = kind != channel_kind::spsc;
+
+            struct sequenced_cell
+            {
+                std::atomic<std::size_t> sequence;
+                ring_slot<T> slot;
+            };
+            struct plain_cell
+            {
+                ring_slot<T> slot;
+            };
+            using cell = std::conditional_t<sequenced, sequenced_cell, plain_cell>;
+
+            // a multi-party side shares its index, a single-party side keeps a cached copy of the other index
+            struct alignas(cache_line) producer_side
+            {
+                std::atomic<std::size_t> position = { 0 };
+                std::size_t cached_consumer = 0;
+            };
+            struct alignas(cache_line) consumer_side
+            {
+                std::atomic<std::size_t> position = { 0 };
+                std::size_t cached_producer = 0;
+            };
+
+            std::size_t mask;
+            std::unique_ptr<cell[]> cells;
+            producer_side producer;
+            consumer_side consumer;
+
+        public:
+            explicit channel_ring(std::size_t capacity) :
+                mask(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1), cells(std::make_unique<cell[]>(mask + 1))
+            {
+                if constexpr (sequenced)
+                    for (std::size_t i = 0; i <= mask; i++)
+                        cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            ~channel_ring()
+            {
+                T discarded;
+                while (try_pop(discarded))
+                    ;
+            }
+            channel_ring(const channel_ring&) = delete;
+            channel_ring& operator=(const channel_ring&) = delete;
+
+            std::size_t capacity() const noexcept { return mask + 1; }
+
+            // args are only consumed when true is returned, the value is built directly in its slot
+            template <typename... Args> bool try_emplace(Args&&... args)
+            {
+                if constexpr (sequenced)
+                {
+                    auto position = producer.position.load(std::memory_order_relaxed);
+                    for (;;)
+                    {
+                        auto& target = cells[position & mask];
+                        auto sequence = target.sequence.load(std::memory_order_acquire);
+                        auto lag = static_cast<std::ptrdiff_t>(sequence - position);
+                        if (lag == 0)
+                        {
+                            if (producer.position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                            {
+                                target.slot.construct(std::forward<Args>(args)...);
+                                target.sequence.store(position + 1, std::memory_order_release);
+                                return true;
+                            }
+                        }
+                        else if (lag < 0)
+                            return false;
+                        else
+                            position = producer.position.load(std::memory_order_relaxed);
+                    }
+                }
+                else
+                {
+                    auto position = producer.position.load(std::memory_order_relaxed);
+                    if (position - producer.cached_consumer > mask)
+                    {
+                        producer.cached_consumer = consumer.position.load(std::memory_order_acquire);
+                        if (position - producer.cached_consumer > mask)
+                            return false;
+                    }
+                    cells[position & mask].slot.construct(std::forward<Args>(args)...);
+                    producer.position.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+
+            bool try_pop(T& out)
+            {
+                if constexpr (kind == channel_kind::mpmc)
+                {
+                    auto position = consumer.position.load(std::memory_order_relaxed);
+                    for (;;)
+                    {
+                        auto& source = cells[position & mask];
+                        auto sequence = source.sequence.load(std::memory_order_acquire);
+                        auto lag = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+                        if (lag == 0)
+                        {
+                            if (consumer.position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                            {
+                                source.slot.take(out);
+                                source.sequence.store(position + mask + 1, std::memory_order_release);
+                                return true;
+                            }
+                        }
+                        else if (lag < 0)
+                            return false;
+                        else
+                            position = consumer.position.load(std::memory_order_relaxed);
+                    }
+                }
+                else if constexpr (kind == channel_kind::mpsc)
+                {
+                    // single consumer: no cas, the position is only published for symmetry
+                    auto position = consumer.position.load(std::memory_order_relaxed);
+                    auto& source = cells[position & mask];
+                    if (source.sequence.load(std::memory_order_acquire) != position + 1)
+                        return false;
+                    source.slot.take(out);
+                    source.sequence.store(position + mask + 1, std::memory_order_release);
+                    consumer.position.store(position + 1, std::memory_order_relaxed);
+                    return true;
+                }
+                else
+                {
+                    auto position = consumer.position.load(std::memory_order_relaxed);
+                    if (position == consumer.cached_producer)
+                    {
+                        consumer.cached_producer = producer.position.load(std::memory_order_acquire);
+                        if (position == consumer.cached_producer)
+                            return false;
+                    }
+                    cells[position & mask].slot.take(out);
+                    consumer.position.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+        };
+
+        // unbounded fallback: a deque under a mutex, try_emplace never reports full
+        template <typename T> class locked_queue
+        {
+            std::deque<T> items;
+            std::mutex mutex;
+
+        public:
+            explicit locked_queue(std::size_t) {}
+
+            template <typename... Args> bool try_emplace(Args&&... args)
+            {
+                std::lock_guard lock(mutex);
+                items.emplace_back(std::forward<Args>(args)...);
+                return true;
+            }
+            bool try_pop(T& out)
+            {
+                std::lock_guard lock(mutex);
+                if (items.empty())
+                    return false;
+                out = std::move(items.front());
+                items.pop_front();
+                return true;
+            }
+        };
+
+        // blocking, close and batch operations over any queue with try_emplace / try_pop.
+        // waiters park on an eventcount, so a send or recv nobody waits on never touches the kernel.
+        template <typename T, typename Queue> class channel_core
+        {
+            Queue queue;
+            std::atomic<bool> is_closed = { false };
+            wait_event not_empty;
+            wait_event not_full;
+            std::atomic<std::uint32_t> spins = { default_spin_count };
+
+        public:
+            static constexpr std::uint32_t default_spin_count = 64;
+
+            explicit channel_core(std::size_t capacity) : queue(capacity) {}
+            channel_core(const channel_core&) = delete;
+            channel_core& operator=(const channel_core&) = delete;
+
+            // wakes every blocked sender and receiver. receivers still drain what was sent before the close,
+            // a send racing the close may or may not be delivered.
+            void close() noexcept
+            {
+                is_closed.store(true, std::memory_order_seq_cst);
+                not_empty.notify_all();
+                not_full.notify_all();
+            }
+            bool closed() const noexcept { return is_closed.load(std::memory_order_acquire); }
+
+            // how many times a blocking call retries before it parks, zero parks right away
+            void set_spin_count(std::uint32_t count) noexcept { spins.store(count, std::memory_order_relaxed); }
+
+            template <typename... Args> channel_status try_emplace(Args&&... args)
+            {
+                if (closed())
+                    return channel_status::closed;
+                if (!queue.try_emplace(std::forward<Args>(args)...))
+                    return channel_status::full;
+                not_empty.notify_one();
+                return channel_status::ok;
+            }
+            template <typename... Args> channel_status emplace(Args&&... args)
+            {
+                // try_emplace only consumes args when it succeeds, so forwarding them on every attempt is fine
+                auto status = channel_status::full;
+                not_full.await([&] { return (status = try_emplace(std::forward<Args>(args)...)) != channel_status::full; }, spin_count());
+                return status;
+            }
+            template <typename U = T> channel_status try_send(U&& value) { return try_emplace(std::forward<U>(value)); }
+            template <typename U = T> channel_status send(U&& value) { return emplace(std::forward<U>(value)); }
+            template <typename U = T> channel_status send(U&& value, std::stop_token st)
+            {
+                auto status = channel_status::full;
+                if (!not_full.await([&] { return (status = try_emplace(std::forward<U>(value))) != channel_status::full; }, spin_count(), st))
+                    return channel_status::stopped;
+                return status;
+            }
+
+            channel_status try_recv(T& out)
+            {
+                if (!queue.try_pop(out))
+                {
+                    if (!closed())
+                        return channel_status::empty;
+                    // pop again after seeing the flag, items sent before the close are never reported as closed
+                    if (!queue.try_pop(out))
+                        return channel_status::closed;
+                }
+                not_full.notify_one();
+                return channel_status::ok;
+            }
+            channel_status recv(T& out, std::stop_token st = {}) { return recv_until(out, st, nullptr); }
+            template <typename Rep, typename Period> channel_status recv_for(T& out, std::chrono::duration<Rep, Period> timeout, std::stop_token st = {})
+            {
+                auto deadline = wait_clock::now() + std::chrono::ceil<wait_clock::duration>(timeout);
+                return recv_until(out, st, &deadline);
+            }
+            template <typename Clock, typename Duration>
+            channel_status recv_until(T& out, std::chrono::time_point<Clock, Duration> deadline, std::stop_token st = {})
+            {
+                auto steady = wait_clock::now() + std::chrono::ceil<wait_clock::duration>(deadline - Clock::now());
+                return recv_until(out, st, &steady);
+            }
+
+            // co_await forms, a coroutine that has to wait is resumed on scheduler (anything with post, usually an async_pool)
+            template <typename Scheduler> auto recv_async(T& out, Scheduler& scheduler)
+            {
+                return event_awaiter(not_empty, scheduler, [this, &out]() -> std::optional<channel_status> {
+                    if (auto status = try_recv(out); status != channel_status::empty)
+                        return status;
+                    return std::nullopt;
+                });
+            }
+            template <typename Scheduler, typename U = T> auto send_async(U&& value, Scheduler& scheduler)
+            {
+                return event_awaiter(not_full, scheduler, [this, value = T(std::forward<U>(value))]() mutable -> std::optional<channel_status> {
+                    if (auto status = try_emplace(std::move(value)); status != channel_status::full)
+                        return status;
+                    return std::nullopt;
+                });
+            }
+
+            // sends as many as fit, waking receivers once per filled stretch instead of once per item.
+            // returns how many were sent, fewer than requested only when the channel was closed. items are
+            // built from *first as it is: plain iterators copy, std::move_iterator moves them in
+            template <typename It> std::size_t send_n(It first, std::size_t count)
+            {
+                static_assert(std::is_constructible_v<T, std::iter_reference_t<It>>, "send_n copies through plain iterators, wrap them in std::make_move_iterator to move the items");
+                auto try_send_next = [&] { return queue.try_emplace(static_cast<std::iter_reference_t<It>>(*first)); };
+                std::size_t sent = 0;
+                while (sent < count)
+                {
+                    if (closed())
+                        break;
+                    auto before = sent;
+                    while (sent < count && try_send_next())
+                    {
+                        ++first;
+                        sent++;
+                    }
+                    if (sent - before == 1)
+                        not_empty.notify_one();
+                    else if (sent != before)
+                        not_empty.notify_all();
+                    if (sent < count)
+                        not_full.await(
+                            [&] {
+                                if (closed() || !try_send_next())
+                                    return closed();
+                                ++first;
+                                sent++;
+                                not_empty.notify_one();
+                                return true;
+                            },
+                            spin_count());
+                }
+                return sent;
+            }
+            // blocks until at least one item arrived or the channel is closed and drained, then takes up to
+            // max_count more without blocking. returns how many were written to out.
+            template <typename OutIt> std::size_t recv_n(OutIt out, std::size_t max_count)
+            {
+                if (max_count == 0)
+                    return 0;
+                T value;
+                if (recv(value) != channel_status::ok)
+                    return 0;
+                *out++ = std::move(value);
+                std::size_t received = 1;
+                while (received < max_count && queue.try_pop(value))
+                {
+                    *out++ = std::move(value);
+                    received++;
+                }
+                if (received == 1)
+                    not_full.notify_one();
+                else
+                    not_full.notify_all();
+                return received;
+            }
+
+        private:
+            std::uint32_t spin_count() const noexcept { return spins.load(std::memory_order_relaxed); }
+
+            channel_status recv_until(T& out, std::stop_token& st, const wait_clock::time_point* deadline)
+            {
+                auto status = channel_status::empty;
+                if (not_empty.await([&] { return (status = try_recv(out)) != channel_status::empty; }, spin_count(), st, deadline))
+                    return status;
+                return st.stop_requested() ? channel_status::stopped : channel_status::timeout;
+            }
+        };
+    } // namespace detail
+
+    // queue semantics, unlike channel<T> every sent value is received exactly once, in order per sender.
+    // lock-free ring of fixed capacity, send blocks while it is full.
+    template <typename T, channel_kind kind = channel_kind::mpmc> class bounded_channel : public detail::channel_core<T, detail::channel_ring<T, kind>>
+    {
+        using core = detail::channel_core<T, detail::channel_ring<T, kind>>;
+
+    public:
+        static_assert(std::is_default_constructible_v<T>, "T must be default constructible");
+        static_assert(std::is_move_assignable_v<T>, "T must be move assignable");
+
+        // drop-in for channel<T>::inlet: set blocks while the channel is full
+        class inlet
+        {
+            bounded_channel& target;
+
+        public:
+            inlet(bounded_channel& channel) : target(channel) {}
+            void set(const T& value) { target.send(value); }
+            void set(T&& value) { target.send(std::move(value)); }
+            template <typename U = T> channel_status send(U&& value) { return target.send(std::forward<U>(value)); }
+            template <typename U = T> channel_status try_send(U&& value) { return target.try_send(std::forward<U>(value)); }
+        };
+
+    public:
+        explicit bounded_channel(std::size_t capacity) : core(capacity) {}
+
+        inlet get_input() { return *this; }
+    };
+
+    // queue semantics without a capacity limit, send never blocks. mutex based, prefer bounded_channel on hot paths.
+    template <typename T> class unbounded_channel : public detail::channel_core<T, detail::locked_queue<T>>
+    {
+        using core = detail::channel_core<T, detail::locked_queue<T>>;
+
+    public:
+        static_assert(std::is_default_constructible_v<T>, "T must be default constructible");
+        static_assert(std::is_move_assignable_v<T>, "T must be move assignable");
+
+        class inlet
+        {
+            unbounded_channel& target;
+
+        public:
+            inlet(unbounded_channel& channel) : target(channel) {}
+            void set(const T& value) { target.send(value); }
+            void set(T&& value) { target.send(std::move(value)); }
+            template <typename U = T> channel_status send(U&& value) { return target.send(std::forward<U>(value)); }
+            template <typename U = T> channel_status try_send(U&& value) { return target.try_send(std::forward<U>(value)); }
+        };
+
+    public:
+        unbounded_channel() : core(0) {}
+
+        inlet get_input() { return *this; }
+    };
+} // namespace stdex
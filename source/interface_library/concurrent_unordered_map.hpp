@@ -0,0 +1,277 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <epoch_reclamation.hpp>
+
+namespace stdex
+{
+    // chained hash map with lock-free reads. writers lock one of a fixed set of stripes, every bucket belongs to
+    // exactly one stripe. nodes are immutable once published: assignment swaps in a new node and retires the old
+    // one through the epoch domain, so a reader never sees a value being written. growing locks every stripe
+    // and relinks the nodes, readers that miss while it runs retry.
+    template <typename Key, typename T, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>> class concurrent_unordered_map
+    {
+        struct node
+        {
+            std::atomic<node*> next = { nullptr };
+            std::size_t hash;
+            std::pair<const Key, T> value;
+
+            template <typename K, typename... Args>
+            node(std::size_t hash, K&& key, Args&&... args)
+                : hash(hash), value(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...))
+            {
+            }
+        };
+        struct table
+        {
+            std::size_t mask;
+            std::unique_ptr<std::atomic<node*>[]> buckets;
+
+            explicit table(std::size_t count) : mask(count - 1), buckets(new std::atomic<node*>[count]) {}
+        };
+        struct alignas(64) stripe
+        {
+            std::mutex mutex;
+        };
+
+        static constexpr std::size_t stripe_count = 64;
+        static constexpr std::size_t max_load = 1; // nodes per bucket before growing
+
+        std::atomic<table*> current;
+        std::atomic<std::uint64_t> resizing = { 0 }; // odd while nodes move to a bigger table
+        std::atomic<std::size_t> count = { 0 };
+        std::array<stripe, stripe_count> stripes;
+        [[no_unique_address]] Hash hasher;
+        [[no_unique_address]] KeyEqual equal;
+
+    private:
+        // std::hash of integers is the identity, mix so the low bits that pick stripe and bucket see every bit
+        std::size_t hash_of(const Key& key) const
+        {
+            std::uint64_t h = hasher(key);
+            h *= 0x9E3779B97F4A7C15ull;
+            return static_cast<std::size_t>(h ^ (h >> 32));
+        }
+        std::mutex& stripe_of(std::size_t hash) { return stripes[hash & (stripe_count - 1)].mutex; }
+
+        // inside an epoch_guard, retries while a resize could have hidden the node
+        const node* find_node(std::size_t hash, const Key& key) const
+        {
+            for (;;)
+            {
+                auto sequence = resizing.load(std::memory_order_acquire);
+                auto t = current.load(std::memory_order_acquire);
+                for (auto n = t->buckets[hash & t->mask].load(std::memory_order_acquire); n != nullptr; n = n->next.load(std::memory_order_acquire))
+                    if (n->hash == hash && equal(n->value.first, key))
+                        return n;
+                if ((sequence & 1) == 0 && resizing.load(std::memory_order_acquire) == sequence)
+                    return nullptr;
+            }
+        }
+        // under the key's stripe lock: the link that points at the key's node, or the bucket head when absent
+        std::pair<std::atomic<node*>*, node*> locate(std::size_t hash, const Key& key)
+        {
+            auto t = current.load(std::memory_order_relaxed);
+            auto link = &t->buckets[hash & t->mask];
+            for (auto n = link->load(std::memory_order_relaxed); n != nullptr; n = n->next.load(std::memory_order_relaxed))
+            {
+                if (n->hash == hash && equal(n->value.first, key))
+                    return { link, n };
+                link = &n->next;
+            }
+            return { &t->buckets[hash & t->mask], nullptr };
+        }
+        void link_front(std::atomic<node*>& head, node* n)
+        {
+            n->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            head.store(n, std::memory_order_release);
+        }
+
+        void lock_all()
+        {
+            for (auto& s : stripes)
+                s.mutex.lock();
+        }
+        void unlock_all()
+        {
+            for (auto& s : stripes)
+                s.mutex.unlock();
+        }
+        void grow_if_loaded()
+        {
+            if (count.load(std::memory_order_relaxed) <= (current.load(std::memory_order_relaxed)->mask + 1) * max_load)
+                return;
+            lock_all();
+            auto old = current.load(std::memory_order_relaxed);
+            if (count.load(std::memory_order_relaxed) <= (old->mask + 1) * max_load)
+                old = nullptr;
+            else
+            {
+                auto bigger = new table((old->mask + 1) * 2);
+                resizing.fetch_add(1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                // nodes are moved front to back, so the chains a reader can be walking stay acyclic
+                for (std::size_t b = 0; b <= old->mask; b++)
+                    for (auto n = old->buckets[b].load(std::memory_order_relaxed); n != nullptr;)
+                    {
+                        auto next = n->next.load(std::memory_order_relaxed);
+                        link_front(bigger->buckets[n->hash & bigger->mask], n);
+                        n = next;
+                    }
+                current.store(bigger, std::memory_order_release);
+                resizing.fetch_add(1, std::memory_order_release);
+            }
+            unlock_all();
+            if (old != nullptr)
+                detail::epoch_domain::instance().retire(old);
+        }
+
+        template <typename K, typename... Args> bool emplace_hashed(std::size_t hash, K&& key, Args&&... args)
+        {
+            {
+                std::lock_guard lock(stripe_of(hash));
+                auto [head, found] = locate(hash, key);
+                if (found != nullptr)
+                    return false;
+                link_front(*head, new node(hash, std::forward<K>(key), std::forward<Args>(args)...));
+            }
+            count.fetch_add(1, std::memory_order_relaxed);
+            grow_if_loaded();
+            return true;
+        }
+
+    public:
+        explicit concurrent_unordered_map(std::size_t bucket_count = stripe_count, const Hash& hash = {}, const KeyEqual& key_equal = {})
+            : hasher(hash), equal(key_equal)
+        {
+            std::size_t buckets = stripe_count;
+            while (buckets < bucket_count)
+                buckets *= 2;
+            current.store(new table(buckets), std::memory_order_relaxed);
+        }
+        ~concurrent_unordered_map()
+        {
+            auto t = current.load(std::memory_order_relaxed);
+            for (std::size_t b = 0; b <= t->mask; b++)
+                for (auto n = t->buckets[b].load(std::memory_order_relaxed); n != nullptr;)
+                    delete std::exchange(n, n->next.load(std::memory_order_relaxed));
+            delete t;
+        }
+        concurrent_unordered_map(const concurrent_unordered_map&) = delete;
+        concurrent_unordered_map& operator=(const concurrent_unordered_map&) = delete;
+
+    public:
+        std::size_t size() const noexcept { return count.load(std::memory_order_relaxed); }
+        bool empty() const noexcept { return size() == 0; }
+
+        // lock-free readers
+        bool contains(const Key& key) const
+        {
+            detail::epoch_guard guard;
+            return find_node(hash_of(key), key) != nullptr;
+        }
+        std::optional<T> get(const Key& key) const
+        {
+            detail::epoch_guard guard;
+            if (auto n = find_node(hash_of(key), key))
+                return n->value.second;
+            return std::nullopt;
+        }
+        // fn(const T&) on the value without copying it, false when the key is absent
+        template <typename Fn> bool visit(const Key& key, Fn&& fn) const
+        {
+            detail::epoch_guard guard;
+            auto n = find_node(hash_of(key), key);
+            if (n == nullptr)
+                return false;
+            std::forward<Fn>(fn)(n->value.second);
+            return true;
+        }
+        // fn(const Key&, const T&) for every entry, one stripe at a time. entries changed meanwhile may or may not be seen
+        template <typename Fn> void for_each(Fn&& fn)
+        {
+            for (std::size_t s = 0; s < stripe_count; s++)
+            {
+                std::lock_guard lock(stripes[s].mutex);
+                auto t = current.load(std::memory_order_relaxed);
+                for (auto b = s; b <= t->mask; b += stripe_count)
+                    for (auto n = t->buckets[b].load(std::memory_order_relaxed); n != nullptr; n = n->next.load(std::memory_order_relaxed))
+                        fn(n->value.first, n->value.second);
+            }
+        }
+
+        // writers, each returns whether the key was new
+        template <typename... Args> bool try_emplace(const Key& key, Args&&... args) { return emplace_hashed(hash_of(key), key, std::forward<Args>(args)...); }
+        template <typename... Args> bool try_emplace(Key&& key, Args&&... args)
+        {
+            auto hash = hash_of(key);
+            return emplace_hashed(hash, std::move(key), std::forward<Args>(args)...);
+        }
+        bool insert(const Key& key, const T& value) { return try_emplace(key, value); }
+        bool insert(Key&& key, T&& value) { return try_emplace(std::move(key), std::move(value)); }
+        template <typename V> bool insert_or_assign(const Key& key, V&& value)
+        {
+            return update(key, [&](const T*) -> T { return std::forward<V>(value); });
+        }
+        // stores fn(current), current is nullptr when the key is absent. fn runs under the stripe lock
+        template <typename Fn> bool update(const Key& key, Fn&& fn)
+        {
+            auto hash = hash_of(key);
+            {
+                std::lock_guard lock(stripe_of(hash));
+                auto [link, found] = locate(hash, key);
+                if (found != nullptr)
+                {
+                    auto replacement = new node(hash, key, fn(&std::as_const(found->value.second)));
+                    replacement->next.store(found->next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                    link->store(replacement, std::memory_order_release);
+                    detail::epoch_domain::instance().retire(found);
+                    return false;
+                }
+                link_front(*link, new node(hash, key, fn(static_cast<const T*>(nullptr))));
+            }
+            count.fetch_add(1, std::memory_order_relaxed);
+            grow_if_loaded();
+            return true;
+        }
+        bool erase(const Key& key)
+        {
+            auto hash = hash_of(key);
+            {
+                std::lock_guard lock(stripe_of(hash));
+                auto [link, found] = locate(hash, key);
+                if (found == nullptr)
+                    return false;
+                link->store(found->next.load(std::memory_order_relaxed), std::memory_order_release);
+                detail::epoch_domain::instance().retire(found);
+            }
+            count.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        void clear()
+        {
+            // unlinked under the locks, retired after them so no destructor runs while every stripe is held
+            std::vector<node*> removed;
+            removed.reserve(size());
+            lock_all();
+            auto t = current.load(std::memory_order_relaxed);
+            for (std::size_t b = 0; b <= t->mask; b++)
+                for (auto n = t->buckets[b].exchange(nullptr, std::memory_order_release); n != nullptr; n = n->next.load(std::memory_order_relaxed))
+                    removed.push_back(n);
+            count.fetch_sub(removed.size(), std::memory_order_relaxed);
+            unlock_all();
+            for (auto n : removed)
+                detail::epoch_domain::instance().retire(n);
+        }
+    };
+} // namespace stdex
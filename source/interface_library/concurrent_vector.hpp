@@ -0,0 +1,163 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace stdex
+{
+    // append-only vector of segments that double in size, so elements never move and references stay valid.
+    // push_back claims an index with one fetch_add and only allocates when it opens a segment. size() counts the
+    // prefix whose elements are fully constructed, a slower push_back holds back the size but never the pushers.
+    // a constructor that throws leaves an empty slot behind so the size can still move past it, for_each skips
+    // those and at() reports them.
+    template <typename T> class concurrent_vector
+    {
+        struct slot
+        {
+            alignas(T) unsigned char storage[sizeof(T)];
+            std::atomic<bool> ready = { false };
+            bool constructed = false; // written before ready, false marks a slot whose constructor threw
+
+            T& value() noexcept { return *std::launder(reinterpret_cast<T*>(storage)); }
+        };
+
+        static constexpr std::size_t first_segment_bits = 3;
+        static constexpr std::size_t first_segment_size = std::size_t(1) << first_segment_bits;
+        static constexpr std::size_t segment_count = sizeof(std::size_t) * 8 - first_segment_bits;
+
+        std::array<std::atomic<slot*>, segment_count> segments = {};
+        std::atomic<std::size_t> reserved = { 0 };
+        std::atomic<std::size_t> published = { 0 };
+
+    private:
+        // segment s holds first_segment_size << s elements, starting at index first_segment_size * (2^s - 1)
+        static std::pair<std::size_t, std::size_t> locate(std::size_t index) noexcept
+        {
+            auto biased = index + first_segment_size;
+            auto segment = static_cast<std::size_t>(std::bit_width(biased >> first_segment_bits)) - 1;
+            return { segment, biased - (first_segment_size << segment) };
+        }
+        slot& claim_slot(std::size_t index)
+        {
+            auto [segment, offset] = locate(index);
+            auto storage = segments[segment].load(std::memory_order_acquire);
+            if (storage == nullptr)
+            {
+                // racing openers each allocate, one wins and the others free theirs
+                auto fresh = new slot[first_segment_size << segment];
+                if (segments[segment].compare_exchange_strong(storage, fresh, std::memory_order_acq_rel, std::memory_order_acquire))
+                    storage = fresh;
+                else
+                    delete[] fresh;
+            }
+            return storage[offset];
+        }
+        const slot* find_slot(std::size_t index) const noexcept
+        {
+            auto [segment, offset] = locate(index);
+            auto storage = segments[segment].load(std::memory_order_acquire);
+            return storage != nullptr ? &storage[offset] : nullptr;
+        }
+        slot& slot_at(std::size_t index) const noexcept
+        {
+            auto [segment, offset] = locate(index);
+            return segments[segment].load(std::memory_order_acquire)[offset];
+        }
+
+        // moves published over every ready slot that follows it, any pusher can finish another one's work.
+        // seq_cst against the ready stores: a pusher either sees the size reach its slot or is seen as ready
+        void publish() noexcept
+        {
+            auto size = published.load(std::memory_order_seq_cst);
+            for (;;)
+            {
+                auto next = find_slot(size);
+                if (next == nullptr || !next->ready.load(std::memory_order_seq_cst))
+                    return;
+                if (published.compare_exchange_weak(size, size + 1, std::memory_order_seq_cst))
+                    size++;
+            }
+        }
+
+    public:
+        concurrent_vector() = default;
+        ~concurrent_vector()
+        {
+            auto size = reserved.load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i < size; i++)
+                if (auto target = find_slot(i); target != nullptr && target->constructed)
+                    const_cast<slot*>(target)->value().~T();
+            for (auto& segment : segments)
+                delete[] segment.load(std::memory_order_relaxed);
+        }
+        concurrent_vector(const concurrent_vector&) = delete;
+        concurrent_vector& operator=(const concurrent_vector&) = delete;
+
+    public:
+        // the returned reference stays valid for the life of the vector. when the constructor throws the slot is
+        // published empty and the exception propagates
+        template <typename... Args> T& emplace_back(Args&&... args)
+        {
+            auto index = reserved.fetch_add(1, std::memory_order_relaxed);
+            auto& target = claim_slot(index);
+            try
+            {
+                new (target.storage) T(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                target.ready.store(true, std::memory_order_seq_cst);
+                publish();
+                throw;
+            }
+            target.constructed = true;
+            target.ready.store(true, std::memory_order_seq_cst);
+            publish();
+            return target.value();
+        }
+        T& push_back(const T& value) { return emplace_back(value); }
+        T& push_back(T&& value) { return emplace_back(std::move(value)); }
+
+        // slots below size() are settled and visible to the calling thread, holding an element unless its
+        // constructor threw
+        std::size_t size() const noexcept { return published.load(std::memory_order_acquire); }
+        bool empty() const noexcept { return size() == 0; }
+        bool constructed(std::size_t index) const noexcept { return index < size() && slot_at(index).constructed; }
+
+        // index must be below size() and constructed
+        T& operator[](std::size_t index) noexcept { return slot_at(index).value(); }
+        const T& operator[](std::size_t index) const noexcept { return slot_at(index).value(); }
+        T& at(std::size_t index)
+        {
+            if (!constructed(index))
+                throw std::out_of_range("concurrent_vector::at");
+            return (*this)[index];
+        }
+        const T& at(std::size_t index) const
+        {
+            if (!constructed(index))
+                throw std::out_of_range("concurrent_vector::at");
+            return (*this)[index];
+        }
+
+        // fn(element) over the elements published when the call started, empty slots are skipped
+        template <typename Fn> void for_each(Fn&& fn)
+        {
+            auto count = size();
+            for (std::size_t i = 0; i < count; i++)
+                if (auto& target = slot_at(i); target.constructed)
+                    fn(target.value());
+        }
+        template <typename Fn> void for_each(Fn&& fn) const
+        {
+            auto count = size();
+            for (std::size_t i = 0; i < count; i++)
+                if (auto& target = slot_at(i); target.constructed)
+                    fn(std::as_const(target.value()));
+        }
+    };
+} // namespace stdex
@@ -0,0 +1,185 @@
+#pragma once
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include <self_releasing_async.hpp>
+
+namespace stdex
+{
+    template <typename T = void> class task;
+
+    namespace detail
+    {
+        // resumes whoever awaited the task, by symmetric transfer so long await chains do not grow the stack
+        struct task_final_awaiter
+        {
+            bool await_ready() const noexcept { return false; }
+            template <typename Promise> std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> finished) const noexcept
+            {
+                auto continuation = finished.promise().continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+            void await_resume() const noexcept {}
+        };
+
+        struct task_promise_base
+        {
+            std::coroutine_handle<> continuation;
+            std::exception_ptr error;
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            task_final_awaiter final_suspend() const noexcept { return {}; }
+            void unhandled_exception() noexcept { error = std::current_exception(); }
+        };
+
+        template <typename T> struct task_promise : task_promise_base
+        {
+            std::optional<T> value;
+
+            task<T> get_return_object() noexcept;
+            template <typename U = T> void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+            T take()
+            {
+                if (error)
+                    std::rethrow_exception(error);
+                return std::move(*value);
+            }
+        };
+        template <> struct task_promise<void> : task_promise_base
+        {
+            task<void> get_return_object() noexcept;
+            void return_void() const noexcept {}
+            void take() const
+            {
+                if (error)
+                    std::rethrow_exception(error);
+            }
+        };
+
+        // fire and forget frame that starts right away and frees itself at the end, the body owns everything it needs
+        struct detached_coroutine
+        {
+            struct promise_type
+            {
+                detached_coroutine get_return_object() const noexcept { return {}; }
+                std::suspend_never initial_suspend() const noexcept { return {}; }
+                std::suspend_never final_suspend() const noexcept { return {}; }
+                void return_void() const noexcept {}
+                void unhandled_exception() const noexcept { std::terminate(); }
+            };
+        };
+    } // namespace detail
+
+    // lazy coroutine: nothing runs until it is awaited, spawned or passed to sync_wait. the awaiting coroutine
+    // continues on whatever thread the task finished on, co_await pool.schedule() to move back onto a pool
+    template <typename T> class [[nodiscard]] task
+    {
+    public:
+        using promise_type = detail::task_promise<T>;
+
+    private:
+        std::coroutine_handle<promise_type> handle;
+
+        struct awaiter
+        {
+            std::coroutine_handle<promise_type> handle;
+            bool await_ready() const noexcept { return handle.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+            T await_resume() { return handle.promise().take(); }
+        };
+
+    public:
+        task() = default;
+        explicit task(std::coroutine_handle<promise_type> handle) noexcept : handle(handle) {}
+        task(task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+        task& operator=(task&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle)
+                    handle.destroy();
+                handle = std::exchange(other.handle, {});
+            }
+            return *this;
+        }
+        ~task()
+        {
+            if (handle)
+                handle.destroy();
+        }
+
+        bool valid() const noexcept { return static_cast<bool>(handle); }
+        bool done() const noexcept { return handle && handle.done(); }
+
+        awaiter operator co_await() const& noexcept { return { handle }; }
+        awaiter operator co_await() const&& noexcept { return { handle }; }
+    };
+
+    namespace detail
+    {
+        template <typename T> task<T> task_promise<T>::get_return_object() noexcept { return task<T>(std::coroutine_handle<task_promise>::from_promise(*this)); }
+        inline task<void> task_promise<void>::get_return_object() noexcept { return task<void>(std::coroutine_handle<task_promise>::from_promise(*this)); }
+
+        inline detached_coroutine run_detached(async_pool& pool, task<void> work)
+        {
+            co_await pool.schedule();
+            co_await work;
+        }
+
+        template <typename T> struct sync_wait_state
+        {
+            std::mutex mutex;
+            std::condition_variable cv;
+            bool finished = false;
+            std::optional<std::conditional_t<std::is_void_v<T>, bool, T>> value;
+            std::exception_ptr error;
+        };
+        template <typename T> detached_coroutine run_signalling(task<T>& work, sync_wait_state<T>& state)
+        {
+            try
+            {
+                if constexpr (std::is_void_v<T>)
+                    co_await work;
+                else
+                    state.value.emplace(co_await work);
+            }
+            catch (...)
+            {
+                state.error = std::current_exception();
+            }
+            // notify under the lock, the waiter may destroy state as soon as it can take it
+            std::lock_guard lock(state.mutex);
+            state.finished = true;
+            state.cv.notify_one();
+        }
+    } // namespace detail
+
+    // starts work on a pool worker without keeping a handle to it, an exception escaping work terminates
+    inline void spawn(detail::async_pool& pool, task<void> work) { detail::run_detached(pool, std::move(work)); }
+    inline void spawn(task<void> work) { spawn(detail::default_pool, std::move(work)); }
+
+    // runs work on the calling thread until its first suspension and blocks until it finished.
+    // blocks a worker when called from a pool job, so keep it at the edges of the program
+    template <typename T> T sync_wait(task<T> work)
+    {
+        detail::sync_wait_state<T> state;
+        detail::run_signalling(work, state);
+        {
+            std::unique_lock lock(state.mutex);
+            state.cv.wait(lock, [&] { return state.finished; });
+        }
+        if (state.error)
+            std::rethrow_exception(state.error);
+        if constexpr (!std::is_void_v<T>)
+            return std::move(*state.value);
+    }
+} // namespace stdex
@@ -0,0 +1,182 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+#elif defined(_WIN32) || defined(_WIN64)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+    #undef NOMINMAX
+    #undef WIN32_LEAN_AND_MEAN
+#endif
+
+namespace stdex
+{
+    // logical cpus as the OS numbers them, grouped by NUMA node. read once from sysfs on linux and from the
+    // node processor masks on windows, elsewhere (or when that fails) every cpu is on node 0
+    class cpu_topology
+    {
+        std::vector<int> allowed;                 // cpus this process may run on
+        std::vector<int> node_of_cpu;             // indexed by cpu, -1 for cpus that were not found
+        std::vector<std::vector<int>> node_cpus;  // indexed by node
+
+    private:
+        // "0-3,8,10-11", also used for node lists
+        static std::vector<int> parse_cpu_list(const std::string& text)
+        {
+            std::vector<int> cpus;
+            std::size_t position = 0;
+            while (position < text.size())
+            {
+                auto end = text.find(',', position);
+                if (end == std::string::npos)
+                    end = text.size();
+                auto item = text.substr(position, end - position);
+                auto dash = item.find('-');
+                try
+                {
+                    auto first = std::stoi(item.substr(0, dash));
+                    auto last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+                    for (auto cpu = first; cpu <= last; cpu++)
+                        cpus.push_back(cpu);
+                }
+                catch (...)
+                {
+                }
+                position = end + 1;
+            }
+            return cpus;
+        }
+
+        void read()
+        {
+#if defined(__linux__)
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            if (::sched_getaffinity(0, sizeof(set), &set) == 0)
+                for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+                    if (CPU_ISSET(cpu, &set))
+                        allowed.push_back(cpu);
+            // node numbers can have gaps, the online list names the ones that exist
+            std::ifstream online("/sys/devices/system/node/online");
+            std::string nodes;
+            if (online && std::getline(online, nodes))
+                for (auto node : parse_cpu_list(nodes))
+                {
+                    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+                    std::string text;
+                    if (!file || !std::getline(file, text))
+                        continue;
+                    if (node >= static_cast<int>(node_cpus.size()))
+                        node_cpus.resize(node + 1);
+                    node_cpus[node] = parse_cpu_list(text);
+                }
+#elif defined(_WIN32) || defined(_WIN64)
+            DWORD_PTR process_mask = 0, system_mask = 0;
+            if (::GetProcessAffinityMask(::GetCurrentProcess(), &process_mask, &system_mask))
+                for (int cpu = 0; cpu < int(sizeof(DWORD_PTR) * 8); cpu++)
+                    if (process_mask & (DWORD_PTR(1) << cpu))
+                        allowed.push_back(cpu);
+            ULONG highest = 0;
+            if (::GetNumaHighestNodeNumber(&highest))
+                for (ULONG node = 0; node <= highest; node++)
+                {
+                    ULONGLONG mask = 0;
+                    auto& cpus = node_cpus.emplace_back();
+                    if (::GetNumaNodeProcessorMask(static_cast<UCHAR>(node), &mask))
+                        for (int cpu = 0; cpu < 64; cpu++)
+                            if (mask & (ULONGLONG(1) << cpu))
+                                cpus.push_back(cpu);
+                }
+#endif
+            if (allowed.empty())
+                for (int cpu = 0; cpu < static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u)); cpu++)
+                    allowed.push_back(cpu);
+            if (node_cpus.empty())
+                node_cpus.push_back(allowed);
+            for (std::size_t node = 0; node < node_cpus.size(); node++)
+                for (auto cpu : node_cpus[node])
+                {
+                    if (cpu >= static_cast<int>(node_of_cpu.size()))
+                        node_of_cpu.resize(cpu + 1, -1);
+                    node_of_cpu[cpu] = static_cast<int>(node);
+                }
+        }
+
+        cpu_topology() { read(); }
+
+    public:
+        static const cpu_topology& system()
+        {
+            static const cpu_topology topology;
+            return topology;
+        }
+
+        const std::vector<int>& allowed_cpus() const noexcept { return allowed; }
+        std::size_t node_count() const noexcept { return node_cpus.size(); }
+        const std::vector<int>& cpus_of(int node) const noexcept { return node_cpus[static_cast<std::size_t>(node)]; }
+        // 0 for cpus the topology does not know
+        int node_of(int cpu) const noexcept
+        {
+            return cpu >= 0 && cpu < static_cast<int>(node_of_cpu.size()) && node_of_cpu[cpu] >= 0 ? node_of_cpu[cpu] : 0;
+        }
+
+        // the allowed cpus taken round robin across nodes, so the first n of them spread over every node
+        std::vector<int> interleaved(const std::vector<int>& cpus) const
+        {
+            std::vector<std::vector<int>> by_node(node_count());
+            for (auto cpu : cpus)
+                by_node[static_cast<std::size_t>(node_of(cpu))].push_back(cpu);
+            std::vector<int> result;
+            for (std::size_t round = 0; result.size() < cpus.size(); round++)
+                for (auto& node : by_node)
+                    if (round < node.size())
+                        result.push_back(node[round]);
+            return result;
+        }
+    };
+
+    namespace detail
+    {
+        // restricts the calling thread to cpus, false when the OS refused or the platform has no affinity call
+        inline bool pin_current_thread(const std::vector<int>& cpus) noexcept
+        {
+            if (cpus.empty())
+                return false;
+#if defined(__linux__)
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (auto cpu : cpus)
+                if (cpu >= 0 && cpu < CPU_SETSIZE)
+                    CPU_SET(cpu, &set);
+            return ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set) == 0;
+#elif defined(_WIN32) || defined(_WIN64)
+            DWORD_PTR mask = 0;
+            for (auto cpu : cpus)
+                if (cpu >= 0 && cpu < int(sizeof(DWORD_PTR) * 8))
+                    mask |= DWORD_PTR(1) << cpu;
+            return mask != 0 && ::SetThreadAffinityMask(::GetCurrentThread(), mask) != 0;
+#else
+            return false;
+#endif
+        }
+
+        // the cpu the calling thread runs on right now, -1 when the platform cannot tell
+        inline int current_cpu() noexcept
+        {
+#if defined(__linux__)
+            return ::sched_getcpu();
+#elif defined(_WIN32) || defined(_WIN64)
+            return static_cast<int>(::GetCurrentProcessorNumber());
+#else
+            return -1;
+#endif
+        }
+    } // namespace detail
+} // namespace stdex
@@ -0,0 +1,157 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace stdex
+{
+    namespace detail
+    {
+        // epoch based reclamation for the lock-free readers of the concurrent containers. readers announce the
+        // global epoch for the length of an epoch_guard, retired memory is freed once the epoch moved on twice,
+        // by then no guard that could still see it is open. one process wide domain, one participant per thread.
+        class epoch_domain
+        {
+            struct retired
+            {
+                void* pointer;
+                void (*destroy)(void*);
+                std::uint64_t epoch;
+            };
+            struct alignas(64) participant
+            {
+                std::atomic<std::uint64_t> epoch = { 0 }; // announced epoch, 0 while outside every guard
+                std::atomic<bool> in_use = { true };
+                participant* next = nullptr;
+                std::uint32_t nesting = 0;
+                std::vector<retired> garbage;
+            };
+            // hands the participant back when its thread exits, unfreed garbage moves to the orphans
+            struct thread_handle
+            {
+                participant* self = nullptr;
+                ~thread_handle()
+                {
+                    if (self != nullptr)
+                        instance().release(*self);
+                }
+            };
+
+            static constexpr std::size_t collect_threshold = 64;
+
+            std::atomic<std::uint64_t> global = { 1 };
+            std::atomic<participant*> participants = { nullptr };
+            std::mutex orphan_mutex;
+            std::vector<retired> orphans;
+
+        private:
+            participant& local()
+            {
+                static thread_local thread_handle handle;
+                if (handle.self == nullptr)
+                    handle.self = &acquire();
+                return *handle.self;
+            }
+            participant& acquire()
+            {
+                for (auto p = participants.load(std::memory_order_acquire); p != nullptr; p = p->next)
+                {
+                    bool expected = false;
+                    if (!p->in_use.load(std::memory_order_relaxed) && p->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                        return *p;
+                }
+                // participants are never freed, the list only grows to the peak thread count
+                auto p = new participant;
+                p->next = participants.load(std::memory_order_relaxed);
+                while (!participants.compare_exchange_weak(p->next, p, std::memory_order_release, std::memory_order_relaxed))
+                    ;
+                return *p;
+            }
+            void release(participant& p)
+            {
+                if (!p.garbage.empty())
+                {
+                    std::lock_guard lock(orphan_mutex);
+                    orphans.insert(orphans.end(), p.garbage.begin(), p.garbage.end());
+                    p.garbage.clear();
+                }
+                p.in_use.store(false, std::memory_order_release);
+            }
+
+            bool try_advance() noexcept
+            {
+                auto epoch = global.load(std::memory_order_seq_cst);
+                for (auto p = participants.load(std::memory_order_acquire); p != nullptr; p = p->next)
+                {
+                    auto announced = p->epoch.load(std::memory_order_seq_cst);
+                    if (announced != 0 && announced != epoch)
+                        return false;
+                }
+                return global.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+            }
+            static void free_expired(std::vector<retired>& garbage, std::uint64_t epoch)
+            {
+                std::size_t kept = 0;
+                for (auto& item : garbage)
+                    if (item.epoch + 2 <= epoch)
+                        item.destroy(item.pointer);
+                    else
+                        garbage[kept++] = item;
+                garbage.resize(kept);
+            }
+            void collect(participant& p)
+            {
+                try_advance();
+                auto epoch = global.load(std::memory_order_seq_cst);
+                free_expired(p.garbage, epoch);
+                std::unique_lock lock(orphan_mutex, std::try_to_lock);
+                if (lock.owns_lock() && !orphans.empty())
+                    free_expired(orphans, epoch);
+            }
+
+        public:
+            // leaked on purpose: threads may still retire while statics are torn down
+            static epoch_domain& instance()
+            {
+                static auto domain = new epoch_domain;
+                return *domain;
+            }
+
+            void enter()
+            {
+                auto& p = local();
+                if (p.nesting++ != 0)
+                    return;
+                p.epoch.store(global.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+            void leave()
+            {
+                auto& p = local();
+                if (--p.nesting == 0)
+                    p.epoch.store(0, std::memory_order_release);
+            }
+
+            // p must already be unreachable for readers that enter after this call
+            template <typename T> void retire(T* pointer)
+            {
+                auto& p = local();
+                p.garbage.push_back({ pointer, [](void* target) { delete static_cast<T*>(target); }, global.load(std::memory_order_seq_cst) });
+                if (p.garbage.size() >= collect_threshold)
+                    collect(p);
+            }
+        };
+
+        class epoch_guard
+        {
+        public:
+            epoch_guard() { epoch_domain::instance().enter(); }
+            ~epoch_guard() { epoch_domain::instance().leave(); }
+            epoch_guard(const epoch_guard&) = delete;
+            epoch_guard& operator=(const epoch_guard&) = delete;
+        };
+    } // namespace detail
+} // namespace stdex
@@ -0,0 +1,90 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace stdex
+{
+    struct jitter_stats
+    {
+        std::uint64_t ticks = 0;
+        std::chrono::nanoseconds p50 = {};
+        std::chrono::nanoseconds p99 = {};
+        std::chrono::nanoseconds max = {};
+    };
+
+    namespace detail
+    {
+        // log2 buckets split into 8 linear sub-buckets, about 12% relative error, relaxed counters only
+        class latency_histogram
+        {
+            static constexpr unsigned sub_bits = 3;
+            static constexpr unsigned max_msb = 40; // ~18 minutes in ns, larger values land in the last bucket
+            static constexpr std::size_t bucket_count = (max_msb - sub_bits + 2) << sub_bits;
+
+            std::array<std::atomic<std::uint64_t>, bucket_count> buckets = {};
+            std::atomic<std::uint64_t> total = { 0 };
+            std::atomic<std::uint64_t> largest = { 0 };
+
+            static std::size_t bucket_of(std::uint64_t value) noexcept
+            {
+                if (value < (1u << sub_bits))
+                    return static_cast<std::size_t>(value);
+                auto msb = static_cast<unsigned>(std::bit_width(value)) - 1;
+                if (msb > max_msb)
+                    return bucket_count - 1;
+                auto sub = (value >> (msb - sub_bits)) & ((1u << sub_bits) - 1);
+                return ((msb - sub_bits + 1) << sub_bits) + static_cast<std::size_t>(sub);
+            }
+            // midpoint of the values a bucket covers
+            static std::uint64_t value_of(std::size_t bucket) noexcept
+            {
+                if (bucket < (1u << sub_bits))
+                    return bucket;
+                auto msb = static_cast<unsigned>(bucket >> sub_bits) + sub_bits - 1;
+                auto shift = msb - sub_bits;
+                auto low = (std::uint64_t(1) << msb) + (std::uint64_t(bucket & ((1u << sub_bits) - 1)) << shift);
+                return low + (std::uint64_t(1) << shift) / 2;
+            }
+
+        public:
+            void record(std::chrono::nanoseconds value) noexcept
+            {
+                auto ns = static_cast<std::uint64_t>(std::max<std::int64_t>(value.count(), 0));
+                buckets[bucket_of(ns)].fetch_add(1, std::memory_order_relaxed);
+                total.fetch_add(1, std::memory_order_relaxed);
+                auto seen = largest.load(std::memory_order_relaxed);
+                while (ns > seen && !largest.compare_exchange_weak(seen, ns, std::memory_order_relaxed))
+                    ;
+            }
+
+            std::uint64_t count() const noexcept { return total.load(std::memory_order_relaxed); }
+            std::chrono::nanoseconds max() const noexcept { return std::chrono::nanoseconds(largest.load(std::memory_order_relaxed)); }
+
+            // taken while writers keep recording, so it is approximate by design
+            std::chrono::nanoseconds percentile(double fraction) const noexcept
+            {
+                std::uint64_t seen = 0;
+                for (auto& bucket : buckets)
+                    seen += bucket.load(std::memory_order_relaxed);
+                if (seen == 0)
+                    return {};
+                auto rank = static_cast<std::uint64_t>(fraction * static_cast<double>(seen - 1)) + 1;
+                std::uint64_t accumulated = 0;
+                for (std::size_t i = 0; i < bucket_count; i++)
+                {
+                    accumulated += buckets[i].load(std::memory_order_relaxed);
+                    if (accumulated >= rank)
+                        return std::chrono::nanoseconds(std::min(value_of(i), largest.load(std::memory_order_relaxed)));
+                }
+                return max();
+            }
+
+            jitter_stats summary() const noexcept { return { count(), percentile(0.50), percentile(0.99), max() }; }
+        };
+    } // namespace detail
+} // namespace stdex
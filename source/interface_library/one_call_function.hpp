@@ -1,6 +1,12 @@
 #pragma once
+#include <atomic>
+#include <cstddef>
 #include <functional>
 #include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
 
 namespace stdex
 {
@@ -24,8 +30,7 @@ namespace stdex
                     return R();
                 caller.swap(cache);
             }
-            if (cache)
-                return cache(std::forward<Args>(args)...);
+            return cache(std::forward<Args>(args)...);
         }
     };
 
@@ -35,4 +40,138 @@ namespace stdex
     };
 
     using one_caller = one_call_function<void()>;
+
+    template <class Signature, std::size_t buffer_size = 48> class inline_one_call_function;
+
+    // one_call_function without the mutex: callables live in inline slots and arming or firing is a single
+    // atomic exchange of the armed slot. firing never allocates or locks; arming only allocates when the
+    // callable does not fit buffer_size or every inline slot is still held by a running or armed call.
+    // the call returns whether it fired, as bool for void R and as std::optional<R> otherwise.
+    template <class R, class... Args, std::size_t buffer_size> class inline_one_call_function<R(Args...), buffer_size>
+    {
+        static_assert(!std::is_reference_v<R>, "R must not be a reference");
+
+    public:
+        using result_type = std::conditional_t<std::is_void_v<R>, bool, std::optional<R>>;
+
+    private:
+        struct slot
+        {
+            alignas(std::max_align_t) std::byte storage[buffer_size];
+            R (*invoke)(void*, Args&&...) = nullptr;
+            void (*destroy)(void*) noexcept = nullptr;
+            std::atomic<bool> busy = { false };
+            bool heap = false;
+
+            template <typename Fn> void construct(Fn&& fn)
+            {
+                using target = std::decay_t<Fn>;
+                if constexpr (sizeof(target) <= buffer_size && alignof(target) <= alignof(std::max_align_t))
+                {
+                    ::new (static_cast<void*>(storage)) target(std::forward<Fn>(fn));
+                    invoke = [](void* self, Args&&... args) -> R { return std::invoke(*static_cast<target*>(self), std::forward<Args>(args)...); };
+                    destroy = [](void* self) noexcept { static_cast<target*>(self)->~target(); };
+                }
+                else
+                {
+                    ::new (static_cast<void*>(storage)) target*(new target(std::forward<Fn>(fn)));
+                    invoke = [](void* self, Args&&... args) -> R { return std::invoke(**static_cast<target**>(self), std::forward<Args>(args)...); };
+                    destroy = [](void* self) noexcept { delete *static_cast<target**>(self); };
+                }
+            }
+        };
+
+        // three cover one armed, one firing and one being armed, more only appear under concurrent arming
+        static constexpr std::size_t slot_count = 3;
+
+        slot slots[slot_count];
+        std::atomic<slot*> armed = { nullptr };
+
+    private:
+        slot* acquire_slot()
+        {
+            for (auto& candidate : slots)
+                if (!candidate.busy.load(std::memory_order_relaxed) && !candidate.busy.exchange(true, std::memory_order_acquire))
+                    return &candidate;
+            auto overflow = new slot;
+            overflow->heap = true;
+            return overflow;
+        }
+        static void release(slot* used) noexcept
+        {
+            used->destroy(used->storage);
+            if (used->heap)
+                delete used;
+            else
+                used->busy.store(false, std::memory_order_release);
+        }
+
+    public:
+        inline_one_call_function() = default;
+        ~inline_one_call_function() { disarm(); }
+        inline_one_call_function(const inline_one_call_function&) = delete;
+        inline_one_call_function& operator=(const inline_one_call_function&) = delete;
+
+    public:
+        // replaces any callable that is armed and has not fired yet, returns true if one was replaced
+        template <typename Fn> bool arm(Fn&& fn)
+        {
+            static_assert(std::is_invocable_r_v<R, std::decay_t<Fn>&, Args...>, "callable does not match the signature");
+            auto next = acquire_slot();
+            try
+            {
+                next->construct(std::forward<Fn>(fn));
+            }
+            catch (...)
+            {
+                if (next->heap)
+                    delete next;
+                else
+                    next->busy.store(false, std::memory_order_release);
+                throw;
+            }
+            auto previous = armed.exchange(next, std::memory_order_acq_rel);
+            if (previous == nullptr)
+                return false;
+            release(previous);
+            return true;
+        }
+        template <typename Fn> inline_one_call_function& operator=(Fn&& fn)
+        {
+            arm(std::forward<Fn>(fn));
+            return *this;
+        }
+        // drops the armed callable without calling it, returns true if there was one
+        bool disarm() noexcept
+        {
+            auto previous = armed.exchange(nullptr, std::memory_order_acq_rel);
+            if (previous == nullptr)
+                return false;
+            release(previous);
+            return true;
+        }
+        bool is_armed() const noexcept { return armed.load(std::memory_order_acquire) != nullptr; }
+
+        // exactly one caller wins the armed callable, everyone else gets false / nullopt
+        result_type operator()(Args... args)
+        {
+            auto fired = armed.exchange(nullptr, std::memory_order_acq_rel);
+            if (fired == nullptr)
+                return result_type();
+            struct release_on_exit
+            {
+                slot* used;
+                ~release_on_exit() { release(used); }
+            } guard{ fired };
+            if constexpr (std::is_void_v<R>)
+            {
+                fired->invoke(fired->storage, std::forward<Args>(args)...);
+                return true;
+            }
+            else
+                return result_type(fired->invoke(fired->storage, std::forward<Args>(args)...));
+        }
+    };
+
+    using inline_one_caller = inline_one_call_function<void()>;
 } // namespace stdex
@@ -0,0 +1,304 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <self_releasing_async.hpp>
+
+namespace stdex
+{
+    namespace detail
+    {
+        // chunks per worker when no grain is given, enough slack for stealing to even out uneven chunks
+        inline constexpr std::size_t chunks_per_worker = 8;
+
+        inline std::size_t chunk_size(const async_pool& pool, std::size_t count, std::size_t grain) noexcept
+        {
+            if (grain != 0)
+                return grain;
+            return std::max<std::size_t>(count / (pool.concurrency() * chunks_per_worker), 1);
+        }
+
+        // shared by every thread that runs chunks of one call. done counts the chunks that ran, the caller may
+        // return as soon as it reaches the chunk count
+        struct fork_join_state
+        {
+            std::size_t chunks = 0;
+            std::atomic<std::size_t> done = { 0 };
+            std::atomic<bool> failed = { false };
+            std::exception_ptr error; // written by the thread that set failed, read after the join
+        };
+        // the upper half of a split, posted to the pool. whoever claims it first runs it: a worker that picks the
+        // job up, or the thread that split it once its own half is done
+        struct forked_range
+        {
+            std::size_t begin;
+            std::size_t end;
+            std::atomic<bool> claimed = { false };
+
+            forked_range(std::size_t begin, std::size_t end) noexcept : begin(begin), end(end) {}
+            bool claim() noexcept { return !claimed.exchange(true, std::memory_order_acq_rel); }
+        };
+
+        template <typename Chunk> void run_chunk(fork_join_state& state, Chunk& chunk, std::size_t index) noexcept
+        {
+            if (!state.failed.load(std::memory_order_relaxed))
+            {
+                try
+                {
+                    chunk(index);
+                }
+                catch (...)
+                {
+                    if (!state.failed.exchange(true))
+                        state.error = std::current_exception();
+                }
+            }
+            if (state.done.fetch_add(1, std::memory_order_acq_rel) + 1 == state.chunks)
+                state.done.notify_all();
+        }
+
+        // runs the chunks [begin, end) this thread claimed. the range is halved until one chunk is left, every
+        // upper half posted to the pool. afterwards the halves no worker took yet are taken back, newest first,
+        // so a thread only ever runs chunks of its own call and never waits for a job that is still queued.
+        // chunk is only touched under a claim, a late worker finds its half claimed and returns
+        template <typename Chunk> void run_range(async_pool& pool, const std::shared_ptr<fork_join_state>& state, Chunk& chunk, std::size_t begin, std::size_t end) noexcept
+        {
+            std::vector<std::shared_ptr<forked_range>> forked;
+            try
+            {
+                while (end - begin > 1)
+                {
+                    auto upper = std::make_shared<forked_range>(begin + (end - begin) / 2, end);
+                    forked.push_back(upper);
+                    pool.post([&pool, state, upper, &chunk] {
+                        if (upper->claim())
+                            run_range(pool, state, chunk, upper->begin, upper->end);
+                    });
+                    end = upper->begin;
+                }
+            }
+            catch (...)
+            {
+                // out of memory while splitting: what was not handed out runs here
+                if (!forked.empty() && forked.back()->end == end)
+                    forked.pop_back();
+            }
+            for (auto index = begin; index < end; index++)
+                run_chunk(*state, chunk, index);
+            for (auto it = forked.rbegin(); it != forked.rend(); ++it)
+                if ((*it)->claim())
+                    run_range(pool, state, chunk, (*it)->begin, (*it)->end);
+        }
+
+        // calls chunk(i) for every i in [0, chunks) and returns once all did, rethrowing the first exception.
+        // the caller splits the range recursively with the pool and then waits only for the halves other
+        // threads already run, so a call from inside a pool job neither runs unrelated jobs nor starves the pool
+        template <typename Chunk> void for_each_chunk(async_pool& pool, std::size_t chunks, Chunk&& chunk)
+        {
+            if (chunks == 0)
+                return;
+            if (chunks == 1)
+            {
+                chunk(0);
+                return;
+            }
+            auto state = std::make_shared<fork_join_state>();
+            state->chunks = chunks;
+            run_range(pool, state, chunk, 0, chunks);
+            for (auto done = state->done.load(std::memory_order_acquire); done != chunks; done = state->done.load(std::memory_order_acquire))
+                state->done.wait(done, std::memory_order_acquire);
+            if (state->error)
+                std::rethrow_exception(state->error);
+        }
+
+        // splits [0, count) into chunks of about size elements and calls body(begin, end) for each
+        template <typename Body> void for_each_block(async_pool& pool, std::size_t count, std::size_t size, Body&& body)
+        {
+            auto chunks = (count + size - 1) / size;
+            for_each_chunk(pool, chunks, [&](std::size_t chunk) { body(chunk * size, std::min(chunk * size + size, count)); });
+        }
+
+        // where the k-th of pieces cuts the merge of the sorted runs [begin, middle) and [middle, end): the longer
+        // run is cut evenly and the other one split at the cut by binary search, so the pieces merge independently
+        template <typename It, typename Compare>
+        std::pair<std::size_t, std::size_t> merge_cut(It from, std::size_t begin, std::size_t middle, std::size_t end, std::size_t k, std::size_t pieces, Compare& comp)
+        {
+            if (k == 0)
+                return { begin, middle };
+            if (k == pieces)
+                return { middle, end };
+            if (middle - begin >= end - middle)
+            {
+                auto left = begin + (middle - begin) * k / pieces;
+                return { left, static_cast<std::size_t>(std::lower_bound(from + middle, from + end, from[left], comp) - from) };
+            }
+            auto right = middle + (end - middle) * k / pieces;
+            return { static_cast<std::size_t>(std::lower_bound(from + begin, from + middle, from[right], comp) - from), right };
+        }
+    } // namespace detail
+
+    // fn(i) for every index in [first, last)
+    template <std::integral Index, typename Fn> void parallel_for(detail::async_pool& pool, Index first, Index last, Fn&& fn, std::size_t grain = 0)
+    {
+        if (!(first < last))
+            return;
+        auto count = static_cast<std::size_t>(last - first);
+        detail::for_each_block(pool, count, detail::chunk_size(pool, count, grain), [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; i++)
+                fn(static_cast<Index>(first + static_cast<Index>(i)));
+        });
+    }
+
+    // fn(element) for every element of [first, last)
+    template <std::random_access_iterator It, typename Fn> void parallel_for(detail::async_pool& pool, It first, It last, Fn&& fn, std::size_t grain = 0)
+    {
+        auto count = static_cast<std::size_t>(std::distance(first, last));
+        detail::for_each_block(pool, count, detail::chunk_size(pool, count, grain), [&](std::size_t begin, std::size_t end) {
+            std::for_each(first + begin, first + end, fn);
+        });
+    }
+
+    template <std::ranges::random_access_range Range, typename Fn> void parallel_for(detail::async_pool& pool, Range&& range, Fn&& fn, std::size_t grain = 0)
+    {
+        parallel_for(pool, std::ranges::begin(range), std::ranges::end(range), std::forward<Fn>(fn), grain);
+    }
+
+    // op must be associative, chunks are reduced independently and combined left to right so the result
+    // does not depend on scheduling. init is folded in once, at the front
+    template <std::random_access_iterator It, typename T, typename BinaryOp = std::plus<>>
+    T parallel_reduce(detail::async_pool& pool, It first, It last, T init, BinaryOp op = {}, std::size_t grain = 0)
+    {
+        auto count = static_cast<std::size_t>(std::distance(first, last));
+        if (count == 0)
+            return init;
+        auto size = detail::chunk_size(pool, count, grain);
+        std::vector<std::optional<T>> partials((count + size - 1) / size);
+        detail::for_each_block(pool, count, size, [&](std::size_t begin, std::size_t end) {
+            T value = first[begin];
+            for (auto i = begin + 1; i < end; i++)
+                value = op(std::move(value), first[i]);
+            partials[begin / size].emplace(std::move(value));
+        });
+        for (auto& partial : partials)
+            init = op(std::move(init), std::move(*partial));
+        return init;
+    }
+
+    template <std::ranges::random_access_range Range, typename T, typename BinaryOp = std::plus<>>
+    T parallel_reduce(detail::async_pool& pool, Range&& range, T init, BinaryOp op = {}, std::size_t grain = 0)
+    {
+        return parallel_reduce(pool, std::ranges::begin(range), std::ranges::end(range), std::move(init), std::move(op), grain);
+    }
+
+    // out must have room for last - first elements and may alias first
+    template <std::random_access_iterator It, std::random_access_iterator Out, typename UnaryOp>
+    Out parallel_transform(detail::async_pool& pool, It first, It last, Out out, UnaryOp op, std::size_t grain = 0)
+    {
+        auto count = static_cast<std::size_t>(std::distance(first, last));
+        detail::for_each_block(pool, count, detail::chunk_size(pool, count, grain), [&](std::size_t begin, std::size_t end) {
+            std::transform(first + begin, first + end, out + begin, op);
+        });
+        return out + count;
+    }
+
+    template <std::ranges::random_access_range Range, std::random_access_iterator Out, typename UnaryOp>
+    Out parallel_transform(detail::async_pool& pool, Range&& range, Out out, UnaryOp op, std::size_t grain = 0)
+    {
+        return parallel_transform(pool, std::ranges::begin(range), std::ranges::end(range), out, std::move(op), grain);
+    }
+
+    // chunks are sorted in parallel, then merged pairwise through a buffer, every merge round in parallel. once
+    // there are fewer pairs than chunks the merges are cut into pieces, so the last rounds stay parallel too.
+    // not stable
+    template <std::random_access_iterator It, typename Compare = std::less<>>
+    void parallel_sort(detail::async_pool& pool, It first, It last, Compare comp = {}, std::size_t grain = 0)
+    {
+        auto count = static_cast<std::size_t>(std::distance(first, last));
+        // below a few thousand elements the merge rounds cost more than they save
+        auto size = std::max<std::size_t>(detail::chunk_size(pool, count, grain), grain != 0 ? 1 : 4096);
+        if (count <= size)
+        {
+            std::sort(first, last, comp);
+            return;
+        }
+        detail::for_each_block(pool, count, size, [&](std::size_t begin, std::size_t end) { std::sort(first + begin, first + end, comp); });
+
+        auto chunks = (count + size - 1) / size;
+        std::vector<std::iter_value_t<It>> buffer(std::make_move_iterator(first), std::make_move_iterator(last));
+        std::vector<std::pair<std::size_t, std::size_t>> cuts;
+        auto round = [&](auto from, auto to, std::size_t width) {
+            auto pairs = (count + 2 * width - 1) / (2 * width);
+            auto pieces = std::max<std::size_t>(chunks / pairs, 1);
+            // all cuts are found before any piece moves elements out of from
+            cuts.clear();
+            for (std::size_t pair = 0; pair < pairs; pair++)
+            {
+                auto begin = pair * 2 * width;
+                for (std::size_t k = 0; k <= pieces; k++)
+                    cuts.push_back(detail::merge_cut(from, begin, std::min(begin + width, count), std::min(begin + 2 * width, count), k, pieces, comp));
+            }
+            detail::for_each_chunk(pool, pairs * pieces, [&](std::size_t job) {
+                auto middle = std::min(job / pieces * 2 * width + width, count);
+                auto [left_begin, right_begin] = cuts[job / pieces * (pieces + 1) + job % pieces];
+                auto [left_end, right_end] = cuts[job / pieces * (pieces + 1) + job % pieces + 1];
+                std::merge(std::make_move_iterator(from + left_begin), std::make_move_iterator(from + left_end), std::make_move_iterator(from + right_begin),
+                           std::make_move_iterator(from + right_end), to + (left_begin + right_begin - middle), comp);
+            });
+        };
+        auto in_buffer = true;
+        for (auto width = size; width < count; width *= 2, in_buffer = !in_buffer)
+        {
+            if (in_buffer)
+                round(buffer.begin(), first, width);
+            else
+                round(first, buffer.begin(), width);
+        }
+        if (in_buffer)
+            detail::for_each_block(pool, count, size, [&](std::size_t begin, std::size_t end) {
+                std::move(buffer.begin() + begin, buffer.begin() + end, first + begin);
+            });
+    }
+
+    template <std::ranges::random_access_range Range, typename Compare = std::less<>>
+    void parallel_sort(detail::async_pool& pool, Range&& range, Compare comp = {}, std::size_t grain = 0)
+    {
+        parallel_sort(pool, std::ranges::begin(range), std::ranges::end(range), std::move(comp), grain);
+    }
+
+    // the same on the default pool
+    template <typename First, typename... Args>
+        requires(!std::is_base_of_v<detail::async_pool, std::remove_cvref_t<First>>)
+    auto parallel_for(First&& first, Args&&... args) -> decltype(parallel_for(detail::default_pool, std::forward<First>(first), std::forward<Args>(args)...))
+    {
+        return parallel_for(detail::default_pool, std::forward<First>(first), std::forward<Args>(args)...);
+    }
+    template <typename First, typename... Args>
+        requires(!std::is_base_of_v<detail::async_pool, std::remove_cvref_t<First>>)
+    auto parallel_reduce(First&& first, Args&&... args) -> decltype(parallel_reduce(detail::default_pool, std::forward<First>(first), std::forward<Args>(args)...))
+    {
+        return parallel_reduce(detail::default_pool, std::forward<First>(first), std::forward<Args>(args)...);
+    }
+    template <typename First, typename... Args>
+        requires(!std::is_base_of_v<detail::async_pool, std::remove_cvref_t<First>>)
+    auto parallel_transform(First&& first, Args&&... args) -> decltype(parallel_transform(detail::default_pool, std::forward<First>(first), std::forward<Args>(args)...))
+    {
+        return parallel_transform(detail::default_pool, std::forward<First>(first), std::forward<Args>(args)...);
+    }
+    template <typename First, typename... Args>
+        requires(!std::is_base_of_v<detail::async_pool, std::remove_cvref_t<First>>)
+    auto parallel_sort(First&& first, Args&&... args) -> decltype(parallel_sort(detail::default_pool, std::forward<First>(first), std::forward<Args>(args)...))
+    {
+        return parallel_sort(detail::default_pool, std::forward<First>(first), std::forward<Args>(args)...);
+    }
+} // namespace stdex
@@ -0,0 +1,395 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <channel.hpp>
+#include <coroutine.hpp>
+
+namespace stdex
+{
+    // what a send into a full stage queue does
+    enum class backpressure_policy
+    {
+        block, // the sender waits for space: stage workers suspend, push() blocks the calling thread
+        drop,  // the item is discarded and counted in the receiving stage's dropped
+    };
+
+    struct stage_options
+    {
+        std::size_t parallelism = 1; // workers draining the stage's queue, items leave out of order above 1
+        std::size_t capacity = 1024; // of the queue in front of the stage, rounded up to a power of two
+        std::size_t batch = 16;      // items a worker takes per wakeup, a full batch yields its pool worker after it
+        backpressure_policy when_full = backpressure_policy::block;
+    };
+
+    // counters since the pipeline was built, take two snapshots for a rate over an interval
+    struct stage_stats
+    {
+        std::string name;
+        std::size_t parallelism = 0;
+        std::uint64_t accepted = 0;  // into the stage's queue
+        std::uint64_t dropped = 0;   // turned away by the full queue
+        std::uint64_t processed = 0; // through the stage's callable, including the items it filtered out
+        std::uint64_t failed = 0;    // the callable threw, the item is lost
+        std::size_t queue_depth = 0; // accepted but not yet taken by a worker
+        double items_per_second = 0; // processed over the pipeline's lifetime
+    };
+    struct pipeline_stats
+    {
+        std::chrono::nanoseconds elapsed = {};
+        std::vector<stage_stats> stages;
+    };
+
+    template <typename In> class pipeline;
+    template <typename In, typename Out> class pipeline_builder;
+
+    namespace detail
+    {
+        // the workers of one pipeline, the last to finish wakes wait()
+        struct pipeline_state
+        {
+            async_pool& pool;
+            std::mutex mutex;
+            std::condition_variable cv;
+            std::size_t running = 0;
+            std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+
+            explicit pipeline_state(async_pool& pool) : pool(pool) {}
+        };
+
+        class pipeline_stage_base
+        {
+        protected:
+            struct alignas(64) stage_counters
+            {
+                std::atomic<std::uint64_t> accepted = { 0 };
+                std::atomic<std::uint64_t> dropped = { 0 };
+                std::atomic<std::uint64_t> dequeued = { 0 };
+                std::atomic<std::uint64_t> processed = { 0 };
+                std::atomic<std::uint64_t> failed = { 0 };
+            };
+
+            std::string name;
+            stage_options options;
+            stage_counters counters;
+            std::atomic<std::size_t> live = { 0 }; // workers still draining, the last one closes the next stage
+
+        public:
+            pipeline_stage_base(std::string_view name, const stage_options& options) : name(name), options(options)
+            {
+                this->options.parallelism = std::max<std::size_t>(options.parallelism, 1);
+                this->options.batch = std::max<std::size_t>(options.batch, 1);
+            }
+            virtual ~pipeline_stage_base() = default;
+            pipeline_stage_base(const pipeline_stage_base&) = delete;
+            pipeline_stage_base& operator=(const pipeline_stage_base&) = delete;
+
+            virtual void launch(pipeline_state& state) = 0;
+            // no more input, the workers drain what was accepted and finish
+            virtual void close() noexcept = 0;
+
+            bool blocks() const noexcept { return options.when_full == backpressure_policy::block; }
+            // senders count once per batch so parallel upstream workers do not share a line per item
+            void record(std::uint64_t accepted, std::uint64_t dropped) noexcept
+            {
+                if (accepted != 0)
+                    counters.accepted.fetch_add(accepted, std::memory_order_relaxed);
+                if (dropped != 0)
+                    counters.dropped.fetch_add(dropped, std::memory_order_relaxed);
+            }
+
+            stage_stats stats(double seconds) const
+            {
+                stage_stats result;
+                result.name = name;
+                result.parallelism = options.parallelism;
+                result.accepted = counters.accepted.load(std::memory_order_relaxed);
+                result.dropped = counters.dropped.load(std::memory_order_relaxed);
+                result.processed = counters.processed.load(std::memory_order_relaxed);
+                result.failed = counters.failed.load(std::memory_order_relaxed);
+                // taken items can be counted before the sender recorded them
+                auto dequeued = counters.dequeued.load(std::memory_order_relaxed);
+                result.queue_depth = result.accepted > dequeued ? static_cast<std::size_t>(result.accepted - dequeued) : 0;
+                result.items_per_second = seconds > 0 ? static_cast<double>(result.processed) / seconds : 0;
+                return result;
+            }
+        };
+
+        // the queue in front of a stage, what upstream stages and pipeline::push send into
+        template <typename T> class pipeline_inlet : public pipeline_stage_base
+        {
+        protected:
+            bounded_channel<T> queue;
+
+        public:
+            pipeline_inlet(std::string_view name, const stage_options& options) : pipeline_stage_base(name, options), queue(options.capacity) {}
+
+            void close() noexcept override { queue.close(); }
+
+            channel_status try_send(T&& value) { return queue.try_send(std::move(value)); }
+            auto send_async(T&& value, async_pool& pool) { return queue.send_async(std::move(value), pool); }
+            // for threads outside the stages, one item at a time
+            bool push(T&& value, bool wait)
+            {
+                auto status = wait && blocks() ? queue.send(std::move(value)) : queue.try_send(std::move(value));
+                return admit(status);
+            }
+            bool admit(channel_status status) noexcept
+            {
+                record(status == channel_status::ok, status == channel_status::full);
+                return status == channel_status::ok;
+            }
+        };
+
+        // a stage may drop items by returning an optional
+        template <typename R> struct stage_result
+        {
+            using type = R;
+            static constexpr bool filters = false;
+        };
+        template <typename R> struct stage_result<std::optional<R>>
+        {
+            using type = R;
+            static constexpr bool filters = true;
+        };
+
+        // Out is void for the sink. workers are coroutines on the pool: an empty queue or a full one under the
+        // block policy suspends them on the channel, nothing polls and no pool thread is held while waiting
+        template <typename In, typename Out, typename Fn> class pipeline_stage : public pipeline_inlet<In>
+        {
+            template <typename, typename> friend class stdex::pipeline_builder;
+            static constexpr bool sink = std::is_void_v<Out>;
+
+            Fn fn;
+            pipeline_inlet<Out>* next = nullptr;
+
+        private:
+            task<void> work(pipeline_state& state)
+            {
+                auto max_batch = this->options.batch;
+                std::vector<In> batch;
+                batch.reserve(max_batch);
+                In value;
+                while (co_await this->queue.recv_async(value, state.pool) == channel_status::ok)
+                {
+                    batch.push_back(std::move(value));
+                    while (batch.size() < max_batch && this->queue.try_recv(value) == channel_status::ok)
+                        batch.push_back(std::move(value));
+                    this->counters.dequeued.fetch_add(batch.size(), std::memory_order_relaxed);
+
+                    std::uint64_t failed = 0, sent = 0, dropped = 0;
+                    for (auto& item : batch)
+                    {
+                        if constexpr (sink)
+                        {
+                            try
+                            {
+                                std::invoke(fn, std::move(item));
+                            }
+                            catch (...)
+                            {
+                                failed++;
+                            }
+                        }
+                        else
+                        {
+                            std::optional<Out> result;
+                            try
+                            {
+                                if constexpr (stage_result<std::invoke_result_t<Fn&, In&&>>::filters)
+                                    result = std::invoke(fn, std::move(item));
+                                else
+                                    result.emplace(std::invoke(fn, std::move(item)));
+                            }
+                            catch (...)
+                            {
+                                failed++;
+                            }
+                            if (!result)
+                                continue;
+                            // downstream only closes after every worker here finished, so ok or full
+                            if (next->blocks())
+                                sent += co_await next->send_async(std::move(*result), state.pool) == channel_status::ok;
+                            else if (next->try_send(std::move(*result)) == channel_status::ok)
+                                sent++;
+                            else
+                                dropped++;
+                        }
+                    }
+                    this->counters.processed.fetch_add(batch.size(), std::memory_order_relaxed);
+                    if (failed != 0)
+                        this->counters.failed.fetch_add(failed, std::memory_order_relaxed);
+                    if constexpr (!sink)
+                        next->record(sent, dropped);
+
+                    // a full batch means more is probably queued, let the other stages have the worker first
+                    auto yield = batch.size() == max_batch;
+                    batch.clear();
+                    if (yield)
+                        co_await state.pool.schedule();
+                }
+                finish(state);
+            }
+            // notify under the lock, the pipeline may be destroyed as soon as wait() can take it
+            void finish(pipeline_state& state)
+            {
+                if constexpr (!sink)
+                    if (this->live.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        next->close();
+                std::lock_guard lock(state.mutex);
+                if (--state.running == 0)
+                    state.cv.notify_all();
+            }
+
+        public:
+            pipeline_stage(std::string_view name, const stage_options& options, Fn fn) : pipeline_inlet<In>(name, options), fn(std::move(fn)) {}
+
+            void launch(pipeline_state& state) override
+            {
+                this->live.store(this->options.parallelism, std::memory_order_relaxed);
+                {
+                    std::lock_guard lock(state.mutex);
+                    state.running += this->options.parallelism;
+                }
+                for (std::size_t i = 0; i < this->options.parallelism; i++)
+                    spawn(state.pool, work(state));
+            }
+        };
+
+        template <typename In> struct pipeline_parts
+        {
+            pipeline_state state;
+            std::vector<std::unique_ptr<pipeline_stage_base>> stages;
+            pipeline_inlet<In>* head = nullptr;
+
+            explicit pipeline_parts(async_pool& pool) : state(pool) {}
+        };
+    } // namespace detail
+
+    // chains stages into a pipeline that takes In. every stage gets a bounded queue in front of it and its own
+    // options, a stage's callable maps one item to the next stage's input or to an optional of it to filter.
+    // parallel workers of a stage call it concurrently.
+    //     auto p = stdex::pipeline_builder<std::string>(pool)
+    //                  .stage("parse", parse, { .parallelism = 4 })
+    //                  .sink("store", store);
+    template <typename In, typename Out = In> class pipeline_builder
+    {
+        template <typename, typename> friend class pipeline_builder;
+
+        std::unique_ptr<detail::pipeline_parts<In>> parts;
+        detail::pipeline_inlet<Out>** tail; // where the next stage is linked in
+
+        pipeline_builder(std::unique_ptr<detail::pipeline_parts<In>> parts, detail::pipeline_inlet<Out>** tail) : parts(std::move(parts)), tail(tail) {}
+
+        template <typename Stage> void link(std::unique_ptr<Stage> created)
+        {
+            *tail = created.get();
+            parts->stages.push_back(std::move(created));
+        }
+
+    public:
+        explicit pipeline_builder(detail::async_pool& pool = detail::default_pool)
+            requires std::is_same_v<In, Out>
+            : parts(std::make_unique<detail::pipeline_parts<In>>(pool)), tail(&parts->head)
+        {
+        }
+
+        template <typename Fn> auto stage(std::string_view name, Fn fn, const stage_options& options = {}) &&
+        {
+            using next_type = typename detail::stage_result<std::invoke_result_t<Fn&, Out&&>>::type;
+            static_assert(!std::is_void_v<next_type>, "a callable that returns nothing ends the pipeline, pass it to sink");
+            auto created = std::make_unique<detail::pipeline_stage<Out, next_type, Fn>>(name, options, std::move(fn));
+            auto next_tail = &created->next;
+            link(std::move(created));
+            return pipeline_builder<In, next_type>(std::move(parts), next_tail);
+        }
+        // the last stage, its workers start with the returned pipeline
+        template <typename Fn> pipeline<In> sink(std::string_view name, Fn fn, const stage_options& options = {}) &&
+        {
+            link(std::make_unique<detail::pipeline_stage<Out, void, Fn>>(name, options, std::move(fn)));
+            return pipeline<In>(std::move(parts));
+        }
+    };
+
+    // a running pipeline. closing it lets the stages drain in order, destroying it closes and waits
+    template <typename In> class pipeline
+    {
+        template <typename, typename> friend class pipeline_builder;
+
+        std::unique_ptr<detail::pipeline_parts<In>> parts;
+
+        explicit pipeline(std::unique_ptr<detail::pipeline_parts<In>> built) : parts(std::move(built))
+        {
+            parts->state.started = std::chrono::steady_clock::now();
+            for (auto& stage : parts->stages)
+                stage->launch(parts->state);
+        }
+
+    public:
+        pipeline(pipeline&&) noexcept = default;
+        pipeline& operator=(pipeline&&) = delete;
+        ~pipeline()
+        {
+            if (parts == nullptr)
+                return;
+            close();
+            wait();
+        }
+
+        // false when the first stage dropped the item or the pipeline is closed. under the block policy push
+        // blocks the calling thread while the first queue is full, use push_async from pool workers
+        bool push(const In& value) { return parts->head->push(In(value), true); }
+        bool push(In&& value) { return parts->head->push(std::move(value), true); }
+        bool try_push(const In& value) { return parts->head->push(In(value), false); }
+        bool try_push(In&& value) { return parts->head->push(std::move(value), false); }
+        // co_await form of push, a coroutine that has to wait for space is resumed on the pool
+        task<bool> push_async(In value)
+        {
+            auto& head = *parts->head;
+            if (!head.blocks())
+                co_return head.admit(head.try_send(std::move(value)));
+            co_return head.admit(co_await head.send_async(std::move(value), parts->state.pool));
+        }
+
+        void close() noexcept { parts->head->close(); }
+        bool finished() const
+        {
+            std::lock_guard lock(parts->state.mutex);
+            return parts->state.running == 0;
+        }
+        // until every stage drained and finished, only returns after close()
+        void wait()
+        {
+            std::unique_lock lock(parts->state.mutex);
+            parts->state.cv.wait(lock, [this] { return parts->state.running == 0; });
+        }
+        template <typename Rep, typename Period> bool wait_for(std::chrono::duration<Rep, Period> timeout)
+        {
+            std::unique_lock lock(parts->state.mutex);
+            return parts->state.cv.wait_for(lock, timeout, [this] { return parts->state.running == 0; });
+        }
+
+        pipeline_stats stats() const
+        {
+            pipeline_stats result;
+            result.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - parts->state.started);
+            auto seconds = std::chrono::duration<double>(result.elapsed).count();
+            for (auto& stage : parts->stages)
+                result.stages.push_back(stage->stats(seconds));
+            return result;
+        }
+    };
+} // namespace stdex
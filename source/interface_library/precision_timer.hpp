@@ -0,0 +1,277 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <atomic_wait.hpp>
+#include <work_stealing_executor.hpp>
+#if defined(__linux__)
+    #include <poll.h>
+    #include <pthread.h>
+    #include <sched.h>
+    #include <sys/eventfd.h>
+    #include <sys/timerfd.h>
+    #include <time.h>
+    #include <unistd.h>
+#elif defined(_WIN32) || defined(_WIN64)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+    #undef NOMINMAX
+    #undef WIN32_LEAN_AND_MEAN
+#endif
+
+namespace stdex
+{
+    enum class precision_backend
+    {
+        nanosleep, // clock_nanosleep(TIMER_ABSTIME) for the final approach, a condition variable before that
+        timerfd,   // absolute timerfd polled together with an eventfd, wakes early for new deadlines at any time
+    };
+
+    struct precision_timer_options
+    {
+        precision_backend backend = precision_backend::nanosleep;
+        std::chrono::nanoseconds spin_window = {}; // zero calibrates from measured sleep overshoot
+        int cpu = -1;                              // pin the timer thread, -1 leaves placement to the OS
+        std::size_t workers = 1;                   // async_pool threads that run precise bodies, apart from its workers
+    };
+
+    namespace detail
+    {
+        // runs due entries inline on its own thread: it sleeps to just before a deadline and spins the rest.
+        // callbacks must be short, a slow one delays every other precise entry of the pool; async_pool only
+        // hands the tick to its precise workers from here.
+        class precision_timer
+        {
+        public:
+            using clock = std::chrono::steady_clock;
+
+        private:
+            struct timer_entry
+            {
+                clock::time_point deadline;
+                std::uint64_t sequence;
+                task_function fire;
+            };
+            struct later
+            {
+                bool operator()(const timer_entry& a, const timer_entry& b) const noexcept
+                {
+                    return a.deadline != b.deadline ? a.deadline > b.deadline : a.sequence > b.sequence;
+                }
+            };
+
+            // below this a condition variable wakes too late, the nanosleep backend sleeps it uninterrupted
+            static constexpr auto coarse_window = std::chrono::milliseconds(1);
+
+            precision_timer_options options;
+            clock::duration spin_window = {};
+            std::vector<timer_entry> heap;
+            std::uint64_t next_sequence = 0;
+            std::mutex mutex;
+            std::condition_variable_any cv;
+#if defined(__linux__)
+            int timer_fd = -1;
+            int wake_fd = -1;
+#endif
+            std::jthread thread;
+
+        private:
+#if defined(__linux__)
+            // steady_clock is CLOCK_MONOTONIC on linux
+            static timespec to_timespec(clock::time_point time) noexcept
+            {
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+                return { static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000) };
+            }
+#endif
+            static void sleep_until(clock::time_point time) noexcept
+            {
+#if defined(__linux__)
+                auto ts = to_timespec(time);
+                while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR)
+                    ;
+#else
+                std::this_thread::sleep_until(time);
+#endif
+            }
+            static void spin_until(clock::time_point time) noexcept
+            {
+                while (clock::now() < time)
+                    cpu_relax();
+            }
+
+            void pin_thread() noexcept
+            {
+#if defined(__linux__)
+                if (options.cpu < 0)
+                    return;
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(options.cpu, &set);
+                ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+#elif defined(_WIN32) || defined(_WIN64)
+                if (options.cpu >= 0)
+                    ::SetThreadAffinityMask(::GetCurrentThread(), DWORD_PTR(1) << options.cpu);
+#endif
+            }
+            // the window covers the 90th percentile of measured sleep overshoot plus a margin
+            clock::duration calibrate() const noexcept
+            {
+                if (options.spin_window > clock::duration::zero())
+                    return options.spin_window;
+                std::array<clock::duration, 20> overshoot;
+                for (auto& sample : overshoot)
+                {
+                    auto target = clock::now() + std::chrono::microseconds(200);
+                    sleep_until(target);
+                    sample = clock::now() - target;
+                }
+                std::sort(overshoot.begin(), overshoot.end());
+                auto window = overshoot[overshoot.size() * 9 / 10] + std::chrono::microseconds(10);
+                return std::clamp<clock::duration>(window, std::chrono::microseconds(10), coarse_window);
+            }
+
+            // returns when wake is reached, an earlier entry arrived or a stop was requested
+            void wait(std::unique_lock<std::mutex>& lock, std::stop_token& st, const clock::time_point* wake)
+            {
+#if defined(__linux__)
+                if (timer_fd >= 0 && wake_fd >= 0)
+                {
+                    itimerspec spec = {};
+                    if (wake != nullptr)
+                        spec.it_value = to_timespec(std::max(*wake, clock::time_point(std::chrono::nanoseconds(1))));
+                    ::timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &spec, nullptr);
+                    lock.unlock();
+                    pollfd fds[2] = { { timer_fd, POLLIN, 0 }, { wake_fd, POLLIN, 0 } };
+                    ::poll(fds, 2, -1);
+                    std::uint64_t drained;
+                    if (fds[0].revents & POLLIN)
+                        std::ignore = ::read(timer_fd, &drained, sizeof(drained));
+                    if (fds[1].revents & POLLIN)
+                        std::ignore = ::read(wake_fd, &drained, sizeof(drained));
+                    lock.lock();
+                    return;
+                }
+#endif
+                if (wake == nullptr)
+                {
+                    cv.wait(lock, st, [this] { return !heap.empty(); });
+                    return;
+                }
+                if (*wake - clock::now() > coarse_window)
+                {
+                    cv.wait_until(lock, st, *wake - coarse_window, [this, deadline = heap.front().deadline] { return heap.front().deadline < deadline; });
+                    return;
+                }
+                auto until = *wake;
+                lock.unlock();
+                sleep_until(until);
+                lock.lock();
+            }
+
+            void run(std::stop_token st)
+            {
+                pin_thread();
+                spin_window = calibrate();
+#if defined(_WIN32) || defined(_WIN64)
+                timeBeginPeriod(1);
+#endif
+                std::unique_lock lock(mutex);
+                while (!st.stop_requested())
+                {
+                    if (heap.empty())
+                    {
+                        wait(lock, st, nullptr);
+                        continue;
+                    }
+                    auto deadline = heap.front().deadline;
+                    auto wake = deadline - spin_window;
+                    if (clock::now() < wake)
+                    {
+                        wait(lock, st, &wake);
+                        continue;
+                    }
+                    if (clock::now() < deadline)
+                    {
+                        lock.unlock();
+                        spin_until(deadline);
+                        lock.lock();
+                    }
+
+                    std::pop_heap(heap.begin(), heap.end(), later{});
+                    auto fire = std::move(heap.back().fire);
+                    heap.pop_back();
+                    lock.unlock();
+                    fire();
+                    lock.lock();
+                }
+#if defined(_WIN32) || defined(_WIN64)
+                timeEndPeriod(1);
+#endif
+            }
+
+            void notify() noexcept
+            {
+                cv.notify_one();
+#if defined(__linux__)
+                if (wake_fd >= 0)
+                {
+                    std::uint64_t one = 1;
+                    std::ignore = ::write(wake_fd, &one, sizeof(one));
+                }
+#endif
+            }
+
+        public:
+            explicit precision_timer(precision_timer_options options = {}) : options(options)
+            {
+#if defined(__linux__)
+                if (options.backend == precision_backend::timerfd)
+                {
+                    timer_fd = ::timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+                    wake_fd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+                }
+#endif
+                thread = std::jthread([this](std::stop_token st) { this->run(st); });
+            }
+            ~precision_timer()
+            {
+                thread.request_stop();
+                notify();
+                thread.join();
+#if defined(__linux__)
+                if (timer_fd >= 0)
+                    ::close(timer_fd);
+                if (wake_fd >= 0)
+                    ::close(wake_fd);
+#endif
+            }
+            precision_timer(const precision_timer&) = delete;
+            precision_timer& operator=(const precision_timer&) = delete;
+
+        public:
+            void schedule_at(clock::time_point deadline, task_function fire)
+            {
+                {
+                    std::lock_guard lock(mutex);
+                    heap.push_back({ deadline, next_sequence++, std::move(fire) });
+                    std::push_heap(heap.begin(), heap.end(), later{});
+                    if (heap.front().sequence != next_sequence - 1)
+                        return;
+                }
+                notify();
+            }
+        };
+    } // namespace detail
+} // namespace stdex
@@ -1,14 +1,31 @@
 #pragma once
-#include <condition_variable>
-#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
 #include <future>
-#include <map>
+#include <iterator>
 #include <memory>
 #include <mutex>
-#include <shared_mutex>
+#include <optional>
+#include <stdexcept>
 #include <stop_token>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <latency_histogram.hpp>
+#include <precision_timer.hpp>
+#include <slab_arena.hpp>
+#include <task_registry.hpp>
+#include <task_stats.hpp>
+#include <timer_scheduler.hpp>
+#include <work_stealing_executor.hpp>
 #if defined(_WIN32) || defined(_WIN64)
     #define WIN32_LEAN_AND_MEAN
     #define NOMINMAX
@@ -18,266 +35,1010 @@
 #endif
 namespace stdex
 {
+    enum class launch_mode
+    {
+        worker_pool,     // start() tasks run on a fixed set of work stealing workers
+        thread_per_task, // start() tasks run on their own std::async thread
+    };
+
+    // where a worker_pool pool's workers run
+    enum class worker_binding
+    {
+        floating, // the OS places them, inside cpus when that is set
+        per_cpu,  // each worker pinned to one cpu, taken round robin across the NUMA nodes
+        per_node, // workers spread over the NUMA nodes, each free to run on any cpu of its node
+    };
+
+    struct async_pool_options
+    {
+        launch_mode mode = launch_mode::worker_pool;
+        std::size_t worker_count = std::thread::hardware_concurrency();
+        precision_timer_options precision = {}; // drives start_forever_high_resolution / start_forever_system_perf
+        bool collect_stats = false;             // per task and per name run counters for async_pool::stats
+        std::vector<int> cpus = {};             // the cpus workers may use, empty for every cpu the process may run on
+        worker_binding binding = worker_binding::floating;
+    };
+
+    // where a task runs, for sharing caches with the tasks that produce or consume its data. only pools whose
+    // workers are bound (per_cpu or per_node) honour it
+    struct placement
+    {
+        enum class kind : std::uint8_t
+        {
+            any,
+            node,       // a worker of that NUMA node
+            near_cpu,   // a worker of the cpu's node
+            pinned_cpu, // the worker pinned to that cpu, or its node when there is none
+            near_task,  // a worker of the node the task last ran on
+        };
+        kind where = kind::any;
+        int index = -1; // node or cpu
+        task_id task = task_id::invalid;
+
+        static placement on_node(int node) noexcept { return { kind::node, node }; }
+        static placement near_cpu(int cpu) noexcept { return { kind::near_cpu, cpu }; }
+        static placement pinned(int cpu) noexcept { return { kind::pinned_cpu, cpu }; }
+        static placement near(task_id task) noexcept { return { kind::near_task, -1, task }; }
+    };
+
+    // what start() does with a task whose name already has max_in_flight tasks running
+    enum class limit_policy
+    {
+        queue,  // registered right away, runs once a running one finishes
+        reject, // not registered, start() returns task_id::invalid
+    };
+    // per name scheduling set with async_pool::configure, the limit applies to start() on a worker_pool pool
+    struct name_options
+    {
+        task_priority priority = task_priority::normal;
+        std::size_t max_in_flight = 0; // 0 for no limit
+        limit_policy when_full = limit_policy::queue;
+    };
+
+    // the error of a task that was cancelled, ran into its deadline or was still waiting at shutdown before it started
+    class task_cancelled : public std::runtime_error
+    {
+    public:
+        task_cancelled() : std::runtime_error("task cancelled before it started") {}
+    };
+
     namespace detail
     {
         struct async_task
         {
             std::string name;
-            std::thread::id id;
+            task_id id;
             std::shared_future<void> future;
         };
+        struct task_control : async_task, registry_hook
+        {
+            std::shared_ptr<task_name> name_owner; // the interned entry, name_entry points into it
+            std::promise<void> done;
+            std::stop_source stop_source;   // cancel, deadlines, stop_forever and shutdown, handed to the body as a token
+            std::future<void> thread;       // dedicated std::async thread, joined when the task is reaped
+            std::shared_ptr<void> schedule; // timer state of delayed and periodic tasks
+            const latency_histogram* lateness = nullptr;
+            std::chrono::steady_clock::time_point created;
+            run_counters counters;                // only fed when the pool collects stats
+            name_counters* name_totals = nullptr; // likewise
+            name_gate* gate = nullptr; // the name's options when it was configured before this task was created
+            bool holds_slot = false;   // admitted through the gate's in flight limit
+            job_target target;         // resolved from the task's placement, every run is submitted there
+            std::atomic<int> last_cpu = { -1 }; // only tracked on pools with bound workers
+            std::atomic<int> completion_refs = { 1 };
+            task_control* next_completed = nullptr;
+
+            task_control() = default;
+            explicit task_control(const arena_allocator<task_control>& allocator) : done(std::allocator_arg, allocator) {}
+        };
+
+        // hung off the interned name by async_pool::configure, lives as long as the pool
+        struct name_gate
+        {
+            std::atomic<task_priority> priority = { task_priority::normal };
+            std::mutex mutex;
+            std::size_t max_in_flight = 0;
+            limit_policy when_full = limit_policy::queue;
+            std::size_t in_flight = 0;
+            std::deque<std::pair<task_control*, task_function>> waiting; // registered tasks held back by the limit
+        };
+        // the task body, called with the task's stop token. callables that take a std::stop_token first get it,
+        // the others are called with their arguments only. one shot bodies forward their arguments, periodic ones reuse them
+        template <bool once, typename Fn, typename... Args> auto bind_task(Fn&& fn, Args&&... args)
+        {
+            return [fn = std::forward<Fn>(fn), ... args = std::forward<Args>(args)](std::stop_token token) mutable {
+                if constexpr (once)
+                {
+                    if constexpr (std::is_invocable_v<std::decay_t<Fn>&, std::stop_token, Args...>)
+                        fn(std::move(token), std::forward<Args>(args)...);
+                    else
+                        fn(std::forward<Args>(args)...);
+                }
+                else
+                {
+                    if constexpr (std::is_invocable_v<std::decay_t<Fn>&, std::stop_token, std::decay_t<Args>&...>)
+                        fn(std::move(token), args...);
+                    else
+                        fn(args...);
+                }
+            };
+        }
+
         class async_pool
         {
-            std::map<std::thread::id, async_task> tasks;
-            std::shared_mutex tasks_mutex;
+            using clock = timer_scheduler::clock;
+
+            // declared first: the registry and the executor's queued closures give their blocks back on destruction
+            slab_arena_ptr arena = slab_arena::create();
+            task_registry<task_control, arena_allocator<std::byte>> tasks{ arena_allocator<std::byte>(arena.get()) };
+            std::atomic<std::uint64_t> next_task_id = { 1 };
+            std::atomic<std::size_t> live_tasks = { 0 };
 
         private:
-            std::jthread runner = std::jthread([this](std::stop_token st) { this->run(st); });
-            std::stop_source runner_stop_source = runner.get_stop_source();
-            std::condition_variable runner_cv;
-            std::mutex runner_mutex;
+            // finished tasks push themselves here, the runner drains the whole list in one exchange
+            std::atomic<task_control*> completed = { nullptr };
+            std::atomic<std::uint32_t> completion_epoch = { 0 };
+            std::atomic<bool> runner_parked = { false };
+            std::stop_source shutdown_source;
+
+        private:
+            launch_mode mode;
+            std::atomic<bool> collect_stats;
+            bool bound_workers;
+            std::atomic<std::size_t> next_placed = { 0 };
+            work_stealing_executor executor;
+            work_stealing_executor precise_executor;
+            timer_scheduler timers;
+            precision_timer precision_timers;
+            std::jthread runner;
 
         private:
             void run(std::stop_token st)
             {
-                while (!st.stop_requested())
+                while (true)
                 {
-                    {
-                        std::unique_lock lock(tasks_mutex);
+                    auto epoch = completion_epoch.load();
+                    reap();
+                    if (st.stop_requested())
+                        break;
+                    runner_parked.store(true);
+                    completion_epoch.wait(epoch);
+                    runner_parked.store(false);
+                }
+            }
 
-                        std::vector<std::thread::id> ids;
-                        for (auto& [id, task] : tasks)
-                            if (task.future.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready)
-                                ids.push_back(id);
+            void reap()
+            {
+                auto head = completed.exchange(nullptr, std::memory_order_acquire);
+                if (head == nullptr)
+                    return;
 
-                        for (auto& id : ids)
-                        {
-                            tasks.erase(id);
-                            forever_stop_sources.erase(id);
-                        }
-                    }
-                    std::unique_lock run_lock(runner_mutex);
-                    runner_cv.wait_for(run_lock, std::chrono::milliseconds(100), [&st] { return st.stop_requested(); });
+                std::size_t count = 0;
+                while (head != nullptr)
+                {
+                    auto id = head->id;
+                    head = head->next_completed;
+                    // dropped outside the shard lock, destroying a control block may join its dedicated thread
+                    tasks.erase(id);
+                    count++;
                 }
+
+                if (live_tasks.fetch_sub(count) == count)
+                    live_tasks.notify_all();
             }
 
+            void complete(task_control& control) noexcept
+            {
+                if (control.completion_refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                    return;
+                auto head = completed.load(std::memory_order_relaxed);
+                do
+                    control.next_completed = head;
+                while (!completed.compare_exchange_weak(head, &control, std::memory_order_release, std::memory_order_relaxed));
+
+                completion_epoch.fetch_add(1);
+                if (runner_parked.load())
+                    completion_epoch.notify_one();
+            }
+
+            // bounded by the bodies already running: everything else is stopped, tasks that never started fail
+            // with task_cancelled, and a body that takes its stop token sees the request too
             void destroy()
             {
+                shutdown_source.request_stop();
+                tasks.for_each_task([](task_control& task) { task.stop_source.request_stop(); });
+                tasks.for_each_name([this](task_name& name) {
+                    if (auto gate = name.gate.load(std::memory_order_acquire); gate != nullptr)
+                        withdraw_waiting(*gate);
+                });
+                for (auto count = live_tasks.load(); count != 0; count = live_tasks.load())
+                    live_tasks.wait(count);
+
+                runner.request_stop();
+                completion_epoch.fetch_add(1);
+                completion_epoch.notify_all();
+                runner.join();
+            }
+
+            task_id issue_id() noexcept { return static_cast<task_id>(next_task_id.fetch_add(1, std::memory_order_relaxed)); }
+
+            arena_allocator<std::byte> allocator() const noexcept { return arena_allocator<std::byte>(arena.get()); }
+
+            // the control block, its promise state, the closure and the registry node all come from the arena
+            std::shared_ptr<task_control> create_task(std::string_view name, int completion_refs)
+            {
+                arena_allocator<task_control> control_allocator(arena.get());
+                auto control = std::allocate_shared<task_control>(control_allocator, control_allocator);
+                control->name_owner = tasks.intern(name);
+                control->name_entry = control->name_owner.get();
+                control->name = name;
+                control->created = clock::now();
+                control->gate = control->name_entry->gate.load(std::memory_order_acquire);
+                if (collect_stats.load(std::memory_order_relaxed))
+                    control->name_totals = &totals_of(*control->name_entry);
+                control->id = issue_id();
+                control->future = control->done.get_future().share();
+                control->completion_refs.store(completion_refs, std::memory_order_relaxed);
+                return control;
+            }
+            // tasks are registered before they are launched, so a completion always finds its entry
+            task_control& register_task(std::shared_ptr<task_control> control)
+            {
+                auto& result = *control;
+                live_tasks.fetch_add(1);
+                tasks.insert(std::move(control));
+                return result;
+            }
+            task_control& register_task(std::string_view name, int completion_refs)
+            {
+                return register_task(create_task(name, completion_refs));
+            }
+
+            // totals outlive the name's tasks, so the registry keeps the name once it has them
+            name_counters& totals_of(task_name& entry)
+            {
+                bool created = false;
+                name_counters* result;
                 {
-                    std::shared_lock lock(tasks_mutex);
-                    for (auto& [id, stop_source] : forever_stop_sources)
-                        stop_source.request_stop();
+                    std::lock_guard lock(entry.members_mutex);
+                    if (entry.counters == nullptr)
+                    {
+                        entry.counters = std::make_shared<name_counters>();
+                        created = true;
+                    }
+                    result = entry.counters.get();
                 }
-                runner_cv.notify_all();
-                std::unique_lock run_lock(runner_mutex);
+                if (created)
+                    tasks.keep(entry);
+                return *result;
+            }
+            // counted before the task's future is satisfied, so a waiter always sees its own run
+            static void record_run(task_control& control, clock::time_point begin, clock::time_point end, bool overrun) noexcept
+            {
+                control.counters.record(begin, end, overrun);
+                if (control.name_totals != nullptr)
+                    control.name_totals->runs.record(begin, end, overrun);
             }
 
-            std::thread::id register_task(std::string name, std::thread::id id, std::shared_future<void> future)
+            template <typename Body> void execute(task_control& control, Body& body) noexcept
             {
+                if (control.stop_source.stop_requested())
                 {
-                    std::unique_lock lock(tasks_mutex);
-                    tasks[id] = { name, id, future };
+                    fail_cancelled(control);
+                    return;
                 }
-                runner_cv.notify_all();
-                return id;
+                if (bound_workers)
+                    control.last_cpu.store(current_cpu(), std::memory_order_relaxed);
+                auto timed = collect_stats.load(std::memory_order_relaxed);
+                auto begin = timed ? clock::now() : clock::time_point();
+                std::exception_ptr error;
+                try
+                {
+                    body(control.stop_source.get_token());
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+                if (timed)
+                    record_run(control, begin, clock::now(), false);
+                if (control.holds_slot)
+                    release_slot(*control.gate);
+                if (error)
+                    control.done.set_exception(error);
+                else
+                    control.done.set_value();
+                complete(control);
             }
 
-        public:
-            async_pool() = default;
-            ~async_pool() { destroy(); }
+            // stopped before its body ran, a slot it was admitted into goes to the next waiting task
+            void fail_cancelled(task_control& control) noexcept
+            {
+                if (control.holds_slot)
+                    release_slot(*control.gate);
+                control.done.set_exception(std::make_exception_ptr(task_cancelled()));
+                complete(control);
+            }
 
-        public:
-            template <typename Fn, typename... Args> std::thread::id start(std::string name, Fn&& fn, Args&&... args)
+            // the timer keeps its own reference to the stop state, the task may be long gone when it fires
+            void arm_deadline(task_control& control, clock::time_point deadline)
             {
-                std::promise<std::thread::id> id_promise;
-                auto task = std::async(std::launch::async, [this, &id_promise, fn = std::forward<Fn>(fn), ... args = std::forward<Args>(args)]() mutable {
-                    id_promise.set_value(std::this_thread::get_id());
-                    fn(std::forward<Args>(args)...);
-                });
+                if (deadline <= clock::now())
+                    control.stop_source.request_stop();
+                else
+                    timers.schedule_at(deadline, [source = control.stop_source]() mutable { source.request_stop(); });
+            }
+            // fails the tasks the gate still holds back, they are registered but never ran
+            std::size_t withdraw_waiting(name_gate& gate, const task_control* only = nullptr)
+            {
+                std::deque<std::pair<task_control*, task_function>> withdrawn;
+                {
+                    std::lock_guard lock(gate.mutex);
+                    if (only == nullptr)
+                        withdrawn.swap(gate.waiting);
+                    else if (auto it = std::find_if(gate.waiting.begin(), gate.waiting.end(), [only](const auto& entry) { return entry.first == only; }); it != gate.waiting.end())
+                    {
+                        withdrawn.push_back(std::move(*it));
+                        gate.waiting.erase(it);
+                    }
+                }
+                for (auto& [control, job] : withdrawn)
+                {
+                    job = {};
+                    control->done.set_exception(std::make_exception_ptr(task_cancelled()));
+                    complete(*control);
+                }
+                return withdrawn.size();
+            }
 
-                return register_task(name, id_promise.get_future().get(), task.share());
+            static task_priority priority_of(const task_control& control) noexcept
+            {
+                return control.gate != nullptr ? control.gate->priority.load(std::memory_order_relaxed) : task_priority::normal;
             }
-            template <typename Fn, typename... Args> std::thread::id start_wait(std::string name, std::chrono::milliseconds wait_time, Fn&& fn, Args&&... args)
+            void submit_task(task_control& control, task_function&& job) { executor.submit(std::move(job), priority_of(control), control.target); }
+            // submits a job the gate let through. the push may fail to allocate, then the job goes back to the front
+            // of the queue and gives its slot up again, the next task of the name that finishes retries it. only
+            // when even that fails is the task failed with the allocation error
+            void admit(name_gate& gate, task_control& control, task_function& job) noexcept
             {
-                std::promise<std::thread::id> id_promise;
+                try
+                {
+                    submit_task(control, std::move(job));
+                    return;
+                }
+                catch (...)
+                {
+                }
+                std::exception_ptr error;
+                {
+                    std::lock_guard lock(gate.mutex);
+                    gate.in_flight--;
+                    try
+                    {
+                        gate.waiting.emplace_front(&control, std::move(job));
+                        return;
+                    }
+                    catch (...)
+                    {
+                        error = std::current_exception();
+                    }
+                }
+                job = {};
+                control.done.set_exception(error);
+                complete(control);
+            }
+            // the finishing task hands its slot straight to the oldest waiting one
+            void release_slot(name_gate& gate) noexcept
+            {
+                task_control* admitted = nullptr;
+                task_function next;
+                {
+                    std::lock_guard lock(gate.mutex);
+                    if (!gate.waiting.empty() && (gate.max_in_flight == 0 || gate.in_flight <= gate.max_in_flight))
+                    {
+                        admitted = gate.waiting.front().first;
+                        next = std::move(gate.waiting.front().second);
+                        gate.waiting.pop_front();
+                    }
+                    else
+                        gate.in_flight--;
+                }
+                if (next)
+                    admit(gate, *admitted, next);
+            }
 
-                auto start_time = std::chrono::high_resolution_clock::now() + wait_time;
-                auto task = std::async(std::launch::async, [this, &id_promise, start_time, fn = std::forward<Fn>(fn), ... args = std::forward<Args>(args)]() mutable {
-                    id_promise.set_value(std::this_thread::get_id());
-                    auto stop_token = runner_stop_source.get_token();
-                    while (stop_token.stop_requested() == false)
+            static std::vector<worker_layout> layout_workers(const async_pool_options& options)
+            {
+                std::vector<worker_layout> result(std::max<std::size_t>(options.worker_count, 1));
+                if (options.binding == worker_binding::floating)
+                {
+                    for (auto& worker : result)
+                        worker.cpus = options.cpus;
+                    return result;
+                }
+                auto& topology = cpu_topology::system();
+                auto cpus = topology.interleaved(options.cpus.empty() ? topology.allowed_cpus() : options.cpus);
+                for (std::size_t i = 0; i < result.size(); i++)
+                {
+                    auto cpu = cpus[i % cpus.size()];
+                    auto& worker = result[i];
+                    worker.node = topology.node_of(cpu);
+                    worker.group = static_cast<std::size_t>(worker.node);
+                    if (options.binding == worker_binding::per_cpu)
                     {
-                        if (std::chrono::high_resolution_clock::now() >= start_time)
+                        worker.cpu = cpu;
+                        worker.cpus = { cpu };
+                    }
+                    else
+                        std::copy_if(cpus.begin(), cpus.end(), std::back_inserter(worker.cpus), [&](int other) { return topology.node_of(other) == worker.node; });
+                }
+                return result;
+            }
+            // round robin over the node's workers, the group scope lets the others of the node steal
+            job_target on_node(int node)
+            {
+                std::size_t count = 0;
+                for (std::size_t w = 0; w < executor.size(); w++)
+                    count += executor.layout(w).node == node;
+                if (count == 0)
+                    return {};
+                auto pick = next_placed.fetch_add(1, std::memory_order_relaxed) % count;
+                for (std::size_t w = 0; w < executor.size(); w++)
+                    if (executor.layout(w).node == node && pick-- == 0)
+                        return { w, job_scope::group };
+                return {};
+            }
+            job_target resolve(const placement& where)
+            {
+                if (!bound_workers || mode != launch_mode::worker_pool)
+                    return {};
+                auto& topology = cpu_topology::system();
+                switch (where.where)
+                {
+                    case placement::kind::node: return on_node(where.index);
+                    case placement::kind::near_cpu: return on_node(topology.node_of(where.index));
+                    case placement::kind::pinned_cpu:
+                        for (std::size_t w = 0; w < executor.size(); w++)
+                            if (executor.layout(w).cpu == where.index)
+                                return { w, job_scope::worker };
+                        return on_node(topology.node_of(where.index));
+                    case placement::kind::near_task:
+                        if (auto task = tasks.find(where.task); task != nullptr)
                         {
-                            fn(std::forward<Args>(args)...);
-                            break;
+                            if (auto cpu = task->last_cpu.load(std::memory_order_relaxed); cpu >= 0)
+                                return on_node(topology.node_of(cpu));
+                            return task->target;
                         }
-                        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                    }
-                });
+                        return {};
+                    default: return {};
+                }
+            }
 
-                return register_task(name, id_promise.get_future().get(), task.share());
+            // the launcher holds the second completion reference until the thread handle is stored
+            template <typename Body> task_id launch_thread(std::string_view name, Body&& body, const clock::time_point* deadline = nullptr)
+            {
+                auto& control = register_task(name, 2);
+                auto id = control.id;
+                if (deadline != nullptr)
+                    arm_deadline(control, *deadline);
+                control.thread = std::async(std::launch::async, [this, &control, body = std::forward<Body>(body)]() mutable { execute(control, body); });
+                complete(control);
+                return id;
             }
 
         private:
-            std::map<std::thread::id, std::stop_source> forever_stop_sources;
+            // shared by the timer entries and executor jobs of one start_wait / start_forever task
+            struct scheduled_task
+            {
+                enum : int
+                {
+                    idle,
+                    running,
+                    finished,
+                };
+                struct stop_handler
+                {
+                    async_pool* pool;
+                    scheduled_task* task;
+                    // a periodic task ends normally, a delayed one that never ran fails with task_cancelled
+                    void operator()() const noexcept { pool->cancel(*task, task->periodic ? nullptr : std::make_exception_ptr(task_cancelled())); }
+                };
+
+                task_control& control;
+                task_function body;
+                bool periodic = false;
+                bool precise = false;
+                clock::duration interval = {};
+                missed_tick_policy policy = missed_tick_policy::catch_up;
+                clock::time_point tick;
+                std::atomic<int> phase = { idle };
+                latency_histogram lateness; // how late each run started against its tick
+                std::stop_token stop_token;
+                std::stop_token shutdown_stop_token;
+                std::optional<std::stop_callback<stop_handler>> stop_callback;
+                std::optional<std::stop_callback<stop_handler>> shutdown_stop_callback;
+
+                scheduled_task(task_control& control, task_function body) : control(control), body(std::move(body)) { control.lateness = &lateness; }
+                bool stop_requested() const noexcept { return stop_token.stop_requested() || shutdown_stop_token.stop_requested(); }
+            };
+
+            void finish(scheduled_task& task, std::exception_ptr error = nullptr) noexcept
+            {
+                if (error)
+                    task.control.done.set_exception(error);
+                else
+                    task.control.done.set_value();
+                complete(task.control);
+            }
+            // an idle task finishes right away, a running one finishes when its current run returns
+            bool cancel(scheduled_task& task, std::exception_ptr error = nullptr) noexcept
+            {
+                int expected = scheduled_task::idle;
+                if (!task.phase.compare_exchange_strong(expected, scheduled_task::finished))
+                    return false;
+                finish(task, error);
+                return true;
+            }
+            void arm(const std::shared_ptr<scheduled_task>& task)
+            {
+                if (task->precise)
+                    precision_timers.schedule_at(task->tick, [this, task] { fire(task); });
+                else
+                    timers.schedule_at(task->tick, [this, task] { fire(task); });
+            }
+            // timer threads only hand ticks over. precise ones run on the precise workers, which nothing else
+            // queues on, so busy workers do not delay them and a slow body only holds up the precise ones
+            void fire(const std::shared_ptr<scheduled_task>& task)
+            {
+                int expected = scheduled_task::idle;
+                if (!task->phase.compare_exchange_strong(expected, scheduled_task::running))
+                    return;
+                if (task->precise)
+                    precise_executor.submit([this, task] { run_scheduled(task); });
+                else
+                    executor.submit([this, task] { run_scheduled(task); }, priority_of(task->control), task->control.target);
+            }
+            static clock::time_point next_tick(const scheduled_task& task, clock::time_point now) noexcept
+            {
+                auto next = task.tick + task.interval;
+                if (next > now || task.interval <= clock::duration::zero())
+                    return next;
+                switch (task.policy)
+                {
+                    case missed_tick_policy::skip: return next + ((now - next) / task.interval + 1) * task.interval;
+                    case missed_tick_policy::coalesce: return now;
+                    default: return next;
+                }
+            }
+            void run_scheduled(const std::shared_ptr<scheduled_task>& task)
+            {
+                if (bound_workers)
+                    task->control.last_cpu.store(current_cpu(), std::memory_order_relaxed);
+                auto begin = clock::now();
+                task->lateness.record(begin - task->tick);
+                std::exception_ptr error;
+                try
+                {
+                    task->body();
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+                if (collect_stats.load(std::memory_order_relaxed))
+                {
+                    auto end = clock::now();
+                    if (task->control.name_totals != nullptr)
+                        task->control.name_totals->lateness.record(begin - task->tick);
+                    record_run(task->control, begin, end, task->periodic && end > task->tick + task->interval);
+                }
+                if (error)
+                {
+                    task->phase.store(scheduled_task::finished);
+                    finish(*task, error);
+                    return;
+                }
+                if (!task->periodic)
+                {
+                    task->phase.store(scheduled_task::finished);
+                    finish(*task);
+                    return;
+                }
+
+                task->tick = next_tick(*task, clock::now());
+                task->phase.store(scheduled_task::idle);
+                // a stop that raced with the run above found the task running and left it to us
+                if (task->stop_requested())
+                    cancel(*task);
+                else
+                    arm(task);
+            }
 
-            std::thread::id register_task(std::string name, std::thread::id id, std::shared_future<void> future, std::stop_source forever_stop_source)
+            template <typename Body> std::shared_ptr<scheduled_task> prepare_scheduled(std::string_view name, Body&& body, bool periodic, const placement& where)
             {
-                std::unique_lock lock(tasks_mutex);
-                tasks[id] = { name, id, future };
-                forever_stop_sources[id] = forever_stop_source;
-                runner_cv.notify_all();
+                auto control = create_task(name, 1);
+                control->target = resolve(where);
+                auto token = control->stop_source.get_token();
+                auto task = std::allocate_shared<scheduled_task>(arena_allocator<scheduled_task>(arena.get()), *control,
+                                                                 task_function(std::allocator_arg, allocator(), [body = std::forward<Body>(body), token]() mutable { body(token); }));
+                task->periodic = periodic;
+                task->stop_token = std::move(token);
+                task->shutdown_stop_token = shutdown_source.get_token();
+                control->schedule = task;
+                register_task(std::move(control));
+                return task;
+            }
+            task_id schedule(const std::shared_ptr<scheduled_task>& task)
+            {
+                auto id = task->control.id;
+                task->shutdown_stop_callback.emplace(task->shutdown_stop_token, scheduled_task::stop_handler{ this, task.get() });
+                task->stop_callback.emplace(task->stop_token, scheduled_task::stop_handler{ this, task.get() });
+                if (task->tick <= clock::now())
+                    fire(task);
+                else
+                    arm(task);
                 return id;
             }
 
         public:
-            template <typename Fn, typename... Args> std::thread::id start_forever(std::string name, std::chrono::milliseconds interval, Fn&& fn, Args&&... args)
+            explicit async_pool(async_pool_options options)
+                : mode(options.mode), collect_stats(options.collect_stats), bound_workers(options.binding != worker_binding::floating),
+                  executor(layout_workers(options)), precise_executor(options.precision.workers), precision_timers(options.precision),
+                  runner([this](std::stop_token st) { this->run(st); })
+            {
+            }
+            explicit async_pool(launch_mode mode = launch_mode::worker_pool, std::size_t worker_count = std::thread::hardware_concurrency())
+                : async_pool(async_pool_options{ mode, worker_count })
+            {
+            }
+            ~async_pool() { destroy(); }
+
+        public:
+            template <typename Fn, typename... Args>
+                requires(!std::is_same_v<std::decay_t<Fn>, placement>)
+            task_id start(std::string_view name, Fn&& fn, Args&&... args)
             {
-                std::promise<std::thread::id> id_promise;
-                std::stop_source forever_stop_source;
-                auto forever_stop_token = forever_stop_source.get_token();
+                return start_task(name, nullptr, {}, std::forward<Fn>(fn), std::forward<Args>(args)...);
+            }
+            template <typename Fn, typename... Args> task_id start(std::string_view name, const placement& where, Fn&& fn, Args&&... args)
+            {
+                return start_task(name, nullptr, where, std::forward<Fn>(fn), std::forward<Args>(args)...);
+            }
+            // the task's stop token is requested at the deadline: a task that has not started by then fails with
+            // task_cancelled, a running one only stops early if its callable takes the token and checks it
+            template <typename Fn, typename... Args> task_id start_until(std::string_view name, clock::time_point deadline, Fn&& fn, Args&&... args)
+            {
+                return start_task(name, &deadline, {}, std::forward<Fn>(fn), std::forward<Args>(args)...);
+            }
+            template <typename Fn, typename... Args> task_id start_for(std::string_view name, std::chrono::milliseconds timeout, Fn&& fn, Args&&... args)
+            {
+                auto deadline = clock::now() + timeout;
+                return start_task(name, &deadline, {}, std::forward<Fn>(fn), std::forward<Args>(args)...);
+            }
+            template <typename Fn, typename... Args> task_id start_wait(std::string_view name, std::chrono::milliseconds wait_time, Fn&& fn, Args&&... args)
+            {
+                return start_wait(name, placement{}, wait_time, std::forward<Fn>(fn), std::forward<Args>(args)...);
+            }
+            template <typename Fn, typename... Args> task_id start_wait(std::string_view name, const placement& where, std::chrono::milliseconds wait_time, Fn&& fn, Args&&... args)
+            {
+                auto task = prepare_scheduled(name, bind_task<true>(std::forward<Fn>(fn), std::forward<Args>(args)...), false, where);
+                task->tick = clock::now() + wait_time;
+                return schedule(task);
+            }
 
-                auto task = std::async(std::launch::async,
-                                       [this, &id_promise, forever_stop_token = std::move(forever_stop_token), interval, fn = std::forward<Fn>(fn), ... args = std::forward<Args>(args)]() mutable {
-                                           id_promise.set_value(std::this_thread::get_id());
+        private:
+            template <typename Fn, typename... Args> task_id start_task(std::string_view name, const clock::time_point* deadline, const placement& where, Fn&& fn, Args&&... args)
+            {
+                auto body = bind_task<true>(std::forward<Fn>(fn), std::forward<Args>(args)...);
+                if (mode == launch_mode::thread_per_task)
+                    return launch_thread(name, std::move(body), deadline);
 
-                                           std::condition_variable cv;
-                                           std::mutex m;
-                                           auto next_until = std::chrono::high_resolution_clock::now() + interval;
+                auto owner = create_task(name, 1);
+                auto& control = *owner;
+                auto id = control.id;
+                control.target = resolve(where);
+                if (deadline != nullptr)
+                    arm_deadline(control, *deadline);
+                task_function job(std::allocator_arg, allocator(), [this, &control, body = std::move(body)]() mutable { execute(control, body); });
+                if (control.gate == nullptr)
+                {
+                    register_task(std::move(owner));
+                    submit_task(control, std::move(job));
+                    return id;
+                }
 
-                                           auto stop_token = runner_stop_source.get_token();
-                                           while (!forever_stop_token.stop_requested() && !stop_token.stop_requested())
-                                           {
-                                               fn(std::forward<Args>(args)...);
-                                               std::unique_lock lock(m);
-                                               cv.wait_until(lock, next_until, [&stop_token, &forever_stop_token] { return stop_token.stop_requested() || forever_stop_token.stop_requested(); });
-                                               next_until += interval;
-                                           }
-                                       });
+                auto& gate = *control.gate;
+                control.holds_slot = true;
+                {
+                    std::lock_guard lock(gate.mutex);
+                    if (gate.max_in_flight != 0 && gate.in_flight >= gate.max_in_flight)
+                    {
+                        if (gate.when_full == limit_policy::reject)
+                            return task_id::invalid;
+                        register_task(std::move(owner));
+                        gate.waiting.emplace_back(&control, std::move(job));
+                        return id;
+                    }
+                    gate.in_flight++;
+                    register_task(std::move(owner));
+                }
+                submit_task(control, std::move(job));
+                return id;
+            }
 
-                return register_task(name, id_promise.get_future().get(), task.share(), forever_stop_source);
+        public:
+            template <typename Fn, typename... Args>
+                requires(!std::is_same_v<std::decay_t<Fn>, missed_tick_policy>)
+            task_id start_forever(std::string_view name, std::chrono::milliseconds interval, Fn&& fn, Args&&... args)
+            {
+                return start_forever(name, interval, missed_tick_policy::catch_up, std::forward<Fn>(fn), std::forward<Args>(args)...);
             }
-            template <typename Fn, typename... Args> std::thread::id start_forever_high_resolution(std::string name, std::chrono::milliseconds interval, Fn&& fn, Args&&... args)
+            template <typename Fn, typename... Args> task_id start_forever(std::string_view name, std::chrono::milliseconds interval, missed_tick_policy policy, Fn&& fn, Args&&... args)
             {
-                std::promise<std::thread::id> id_promise;
-                std::stop_source forever_stop_source;
-                auto forever_stop_token = forever_stop_source.get_token();
-
-                auto task = std::async(std::launch::async,
-                                       [this, &id_promise, forever_stop_token = std::move(forever_stop_token), interval, fn = std::forward<Fn>(fn), ... args = std::forward<Args>(args)]() mutable {
-                                           id_promise.set_value(std::this_thread::get_id());
-#if defined(_WIN32) || defined(_WIN64)
-                                           timeBeginPeriod(1);
-#endif
-                                           auto next_until = std::chrono::high_resolution_clock::now() + interval;
-
-                                           auto stop_token = runner_stop_source.get_token();
-                                           while (!forever_stop_token.stop_requested() && !stop_token.stop_requested())
-                                           {
-                                               fn(std::forward<Args>(args)...);
-
-                                               while (!forever_stop_token.stop_requested() && !stop_token.stop_requested())
-                                               {
-                                                   auto now = std::chrono::high_resolution_clock::now();
-                                                   if (now >= next_until)
-                                                       break;
-                                                   auto remaining = next_until - now;
-                                                   if (remaining > std::chrono::milliseconds(2))
-                                                       std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                                                   else
-                                                       std::this_thread::yield();
-                                               }
-
-                                               next_until += interval;
-                                           }
-#if defined(_WIN32) || defined(_WIN64)
-                                           timeEndPeriod(1);
-#endif
-                                       });
+                return start_periodic(name, {}, interval, policy, false, std::forward<Fn>(fn), std::forward<Args>(args)...);
+            }
+            template <typename Fn, typename... Args>
+                requires(!std::is_same_v<std::decay_t<Fn>, missed_tick_policy>)
+            task_id start_forever(std::string_view name, const placement& where, std::chrono::milliseconds interval, Fn&& fn, Args&&... args)
+            {
+                return start_forever(name, where, interval, missed_tick_policy::catch_up, std::forward<Fn>(fn), std::forward<Args>(args)...);
+            }
+            template <typename Fn, typename... Args>
+            task_id start_forever(std::string_view name, const placement& where, std::chrono::milliseconds interval, missed_tick_policy policy, Fn&& fn, Args&&... args)
+            {
+                return start_periodic(name, where, interval, policy, false, std::forward<Fn>(fn), std::forward<Args>(args)...);
+            }
+            template <typename Fn, typename... Args>
+                requires(!std::is_same_v<std::decay_t<Fn>, missed_tick_policy>)
+            task_id start_forever_high_resolution(std::string_view name, std::chrono::milliseconds interval, Fn&& fn, Args&&... args)
+            {
+                return start_forever_high_resolution(name, interval, missed_tick_policy::catch_up, std::forward<Fn>(fn), std::forward<Args>(args)...);
+            }
+            template <typename Fn, typename... Args>
+            task_id start_forever_high_resolution(std::string_view name, std::chrono::milliseconds interval, missed_tick_policy policy, Fn&& fn, Args&&... args)
+            {
+                return start_periodic(name, {}, interval, policy, true, std::forward<Fn>(fn), std::forward<Args>(args)...);
+            }
 
-                return register_task(name, id_promise.get_future().get(), task.share(), forever_stop_source);
+        private:
+            // the first run is immediate, later ones follow the interval and missed tick policy
+            template <typename Fn, typename... Args>
+            task_id start_periodic(std::string_view name, const placement& where, std::chrono::milliseconds interval, missed_tick_policy policy, bool precise, Fn&& fn, Args&&... args)
+            {
+                auto task = prepare_scheduled(name, bind_task<false>(std::forward<Fn>(fn), std::forward<Args>(args)...), true, where);
+                task->interval = interval;
+                task->policy = policy;
+                task->precise = precise;
+                task->tick = clock::now();
+                return schedule(task);
             }
 
-            template <typename Fn, typename... Args> std::thread::id start_forever_system_perf(std::string name, std::chrono::milliseconds interval, Fn&& fn, Args&&... args)
+        public:
+            // windows keeps its QueryPerformanceCounter thread, elsewhere this shares the precision timer with start_forever_high_resolution
+            template <typename Fn, typename... Args> task_id start_forever_system_perf(std::string_view name, std::chrono::milliseconds interval, Fn&& fn, Args&&... args)
             {
-                std::promise<std::thread::id> id_promise;
-                std::stop_source forever_stop_source;
-                auto forever_stop_token = forever_stop_source.get_token();
-                auto task = std::async(std::launch::async,
-                                       [this, &id_promise, forever_stop_token = std::move(forever_stop_token), interval, fn = std::forward<Fn>(fn), ... args = std::forward<Args>(args)]() mutable {
-                                           id_promise.set_value(std::this_thread::get_id());
 #if defined(_WIN32) || defined(_WIN64)
-                                           timeBeginPeriod(1);
-                                           LARGE_INTEGER freq;
-                                           ::QueryPerformanceFrequency(&freq);
-                                           const LONGLONG interval_counts = (interval.count() * freq.QuadPart) / 1000;
-
-                                           LARGE_INTEGER next_time;
-                                           ::QueryPerformanceCounter(&next_time);
-                                           next_time.QuadPart += interval_counts;
-                                           auto stop_token = runner_stop_source.get_token();
-                                           while (!forever_stop_token.stop_requested() && !stop_token.stop_requested())
-                                           {
-                                               fn(std::forward<Args>(args)...);
-                                               while (!forever_stop_token.stop_requested() && !stop_token.stop_requested())
-                                               {
-                                                   LARGE_INTEGER current_time;
-                                                   ::QueryPerformanceCounter(&current_time);
-                                                   if (current_time.QuadPart >= next_time.QuadPart)
-                                                       break;
-                                                   const LONGLONG remaining = next_time.QuadPart - current_time.QuadPart;
-                                                   const double remaining_ms = (remaining * 1000.0) / freq.QuadPart;
-                                                   if (remaining_ms > 2.0)
-                                                       std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                                                   else
-                                                       ::Sleep(0); // more high resolution wait, high cpu used.
-                                               }
-                                               next_time.QuadPart += interval_counts;
-                                           }
-                                           timeEndPeriod(1);
+                return launch_thread(
+                    name,
+                    [this, interval, fn = std::forward<Fn>(fn), ... args = std::forward<Args>(args)](std::stop_token forever_stop_token) mutable {
+                        timeBeginPeriod(1);
+                        LARGE_INTEGER freq;
+                        ::QueryPerformanceFrequency(&freq);
+                        const LONGLONG interval_counts = (interval.count() * freq.QuadPart) / 1000;
+
+                        LARGE_INTEGER next_time;
+                        ::QueryPerformanceCounter(&next_time);
+                        next_time.QuadPart += interval_counts;
+                        auto stop_token = shutdown_source.get_token();
+                        while (!forever_stop_token.stop_requested() && !stop_token.stop_requested())
+                        {
+                            fn(std::forward<Args>(args)...);
+                            while (!forever_stop_token.stop_requested() && !stop_token.stop_requested())
+                            {
+                                LARGE_INTEGER current_time;
+                                ::QueryPerformanceCounter(&current_time);
+                                if (current_time.QuadPart >= next_time.QuadPart)
+                                    break;
+                                const LONGLONG remaining = next_time.QuadPart - current_time.QuadPart;
+                                const double remaining_ms = (remaining * 1000.0) / freq.QuadPart;
+                                if (remaining_ms > 2.0)
+                                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                                else
+                                    ::Sleep(0); // more high resolution wait, high cpu used.
+                            }
+                            next_time.QuadPart += interval_counts;
+                        }
+                        timeEndPeriod(1);
+                    });
+#else
+                return start_periodic(name, {}, interval, missed_tick_policy::catch_up, true, std::forward<Fn>(fn), std::forward<Args>(args)...);
 #endif
-                                       });
-                return register_task(name, id_promise.get_future().get(), task.share(), forever_stop_source);
+            }
+
+            // untracked work for the library's other primitives: no name, id or completion bookkeeping,
+            // the caller keeps whatever job touches alive until it ran. nothing reports an exception that
+            // escapes the job, it is dropped and the worker goes on
+            void post(task_function job) { executor.submit(std::move(job)); }
+            // runs one queued job on the caller, false when there was none
+            bool help() { return executor.try_run_one(); }
+            std::size_t concurrency() const noexcept { return executor.size(); }
+
+            // co_await pool.schedule() continues the coroutine on a worker
+            struct schedule_awaiter
+            {
+                async_pool& pool;
+                bool await_ready() const noexcept { return false; }
+                void await_suspend(std::coroutine_handle<> awaiting) { pool.post([awaiting] { awaiting.resume(); }); }
+                void await_resume() const noexcept {}
+            };
+            schedule_awaiter schedule() noexcept { return { *this }; }
+
+            // co_await pool.delay(d) continues on a worker once d passed, the timer thread only hands it over.
+            // a coroutine still waiting when the pool is destroyed is never resumed
+            struct delay_awaiter
+            {
+                async_pool& pool;
+                clock::time_point deadline;
+                bool await_ready() const noexcept { return deadline <= clock::now(); }
+                void await_suspend(std::coroutine_handle<> awaiting)
+                {
+                    pool.timers.schedule_at(deadline, [pool = &pool, awaiting] { pool->post([awaiting] { awaiting.resume(); }); });
+                }
+                void await_resume() const noexcept {}
+            };
+            delay_awaiter delay_until(clock::time_point deadline) noexcept { return { *this, deadline }; }
+            template <typename Rep, typename Period> delay_awaiter delay(std::chrono::duration<Rep, Period> duration) noexcept
+            {
+                return { *this, clock::now() + std::chrono::ceil<clock::duration>(duration) };
             }
 
         public:
-            std::vector<async_task> names(std::string name)
+            std::vector<async_task> names(std::string_view name)
             {
                 std::vector<async_task> result;
-                std::shared_lock lock(tasks_mutex);
-                for (auto& [_, task] : tasks)
-                    if (task.name == name)
-                        result.push_back(task);
+                tasks.for_each(name, [&result](const task_control& task) { result.push_back(task); });
                 return result;
             }
-            std::shared_ptr<async_task> id(std::thread::id id)
+            // shares ownership of the live control block, no allocation per query
+            std::shared_ptr<const async_task> id(task_id id) { return tasks.find(id); }
+            std::size_t count(std::string_view name) { return tasks.count(name); }
+            bool has(std::string_view name) { return tasks.count(name) != 0; }
+            bool has(task_id id) { return tasks.contains(id); }
+            // lateness of each run against its tick, only start_wait / start_forever* tasks are timed
+            std::optional<jitter_stats> jitter(task_id id)
+            {
+                auto task = tasks.find(id);
+                if (task == nullptr || task->lateness == nullptr)
+                    return std::nullopt;
+                return task->lateness->summary();
+            }
+            // walks the registry one shard at a time without stopping any task, finished tasks only show in
+            // their name's totals. counters are empty unless the pool was created with collect_stats.
+            // tasks created while collection was off keep counting per task but not into their name's totals
+            void enable_stats(bool enabled) noexcept { collect_stats.store(enabled, std::memory_order_relaxed); }
+            pool_stats stats()
+            {
+                pool_stats result;
+                result.memory = arena->stats();
+                tasks.for_each_task([&](const task_control& task) {
+                    auto& entry = result.tasks.emplace_back();
+                    entry.id = task.id;
+                    entry.name = task.name;
+                    entry.created = task.created;
+                    entry.runs = task.counters.snapshot();
+                    if (task.lateness != nullptr)
+                        entry.lateness = task.lateness->summary();
+                });
+                tasks.for_each_name([&](task_name& name) {
+                    std::shared_ptr<name_counters> totals;
+                    {
+                        std::lock_guard lock(name.members_mutex);
+                        totals = name.counters;
+                    }
+                    auto& entry = result.names.emplace_back();
+                    entry.name = name.text;
+                    entry.live = name.live.load(std::memory_order_relaxed);
+                    if (totals != nullptr)
+                    {
+                        entry.runs = totals->runs.snapshot();
+                        entry.lateness = totals->lateness.summary();
+                    }
+                });
+                return result;
+            }
+
+        public:
+            // priority and in flight limit for every task started under name from now on. tasks that already
+            // exist keep the options they were created with, raising the limit starts waiting ones right away
+            void configure(std::string_view name, const name_options& options)
+            {
+                auto owner = tasks.intern(name);
+                auto& entry = *owner;
+                name_gate* gate;
+                {
+                    std::lock_guard lock(entry.members_mutex);
+                    if (entry.gate_owner == nullptr)
+                    {
+                        entry.gate_owner = std::make_shared<name_gate>();
+                        entry.gate.store(entry.gate_owner.get(), std::memory_order_release);
+                    }
+                    gate = entry.gate_owner.get();
+                }
+                tasks.keep(entry);
+                gate->priority.store(options.priority, std::memory_order_relaxed);
+                std::vector<std::pair<task_control*, task_function>> admitted;
+                {
+                    std::lock_guard lock(gate->mutex);
+                    gate->max_in_flight = options.max_in_flight;
+                    gate->when_full = options.when_full;
+                    while (!gate->waiting.empty() && (gate->max_in_flight == 0 || gate->in_flight < gate->max_in_flight))
+                    {
+                        admitted.push_back(std::move(gate->waiting.front()));
+                        gate->waiting.pop_front();
+                        gate->in_flight++;
+                    }
+                }
+                for (auto& [control, job] : admitted)
+                    admit(*gate, *control, job);
+            }
+
+            // a name is a task group: wait_all waits for every task of the name that exists when it is called
+            void wait_all(std::string_view name)
+            {
+                std::vector<std::shared_future<void>> futures;
+                tasks.for_each(name, [&futures](const task_control& task) { futures.push_back(task.future); });
+                for (auto& future : futures)
+                    future.wait();
+            }
+            // requests every task's stop token: tasks of the name that have not started yet fail with task_cancelled,
+            // periodic ones stop after their current run, running bodies see the token. returns how many were stopped
+            std::size_t cancel(std::string_view name)
+            {
+                std::size_t cancelled = 0;
+                tasks.for_each(name, [&cancelled](task_control& task) { cancelled += task.stop_source.request_stop(); });
+                if (auto entry = tasks.find_name(name); entry != nullptr)
+                    if (auto gate = entry->gate.load(std::memory_order_acquire); gate != nullptr)
+                        withdraw_waiting(*gate);
+                return cancelled;
+            }
+            bool cancel(task_id id)
             {
-                std::shared_lock lock(tasks_mutex);
                 auto task = tasks.find(id);
-                if (task == tasks.end())
-                    return nullptr;
-                return std::make_shared<async_task>(task->second);
+                if (task == nullptr || !task->stop_source.request_stop())
+                    return false;
+                if (task->gate != nullptr && task->holds_slot)
+                    withdraw_waiting(*task->gate, task.get());
+                return true;
+            }
+            // requests the task's stop token once deadline passed, false when the task already finished
+            bool set_deadline(task_id id, clock::time_point deadline)
+            {
+                auto task = tasks.find(id);
+                if (task == nullptr)
+                    return false;
+                arm_deadline(*task, deadline);
+                return true;
             }
 
         public:
-            void wait(std::thread::id id)
+            void wait(task_id id)
             {
                 auto task = this->id(id);
                 if (task == nullptr)
                     return;
                 task->future.wait();
             }
-            void stop_forever(std::thread::id id)
+            void stop_forever(task_id id)
             {
-                auto forever_stop_source = forever_stop_sources.find(id);
-                if (forever_stop_source == forever_stop_sources.end())
+                auto task = tasks.find(id);
+                if (task == nullptr)
                     return;
-                forever_stop_source->second.request_stop();
+                task->stop_source.request_stop();
             }
         };
 
-        static inline async_pool default_pool;
+        // one pool per program, every translation unit shares its threads and its task names
+        inline async_pool default_pool;
     } // namespace detail
 
     struct self_releasing_async
@@ -288,63 +1049,154 @@ namespace stdex
         self_releasing_async(stdex::detail::async_pool& pool) : pool(pool) {}
         ~self_releasing_async() = default;
 
-        bool has(std::string name) { return !pool.names(name).empty(); }
-        bool has(std::thread::id id) { return pool.id(id) != nullptr; }
-        void wait(std::thread::id id) { pool.wait(id); }
-        void stop_forever(std::thread::id id) { pool.stop_forever(id); }
+        bool has(std::string_view name) { return pool.has(name); }
+        bool has(task_id id) { return pool.has(id); }
+        std::size_t count(std::string_view name) { return pool.count(name); }
+        std::optional<jitter_stats> jitter(task_id id) { return pool.jitter(id); }
+        pool_stats stats() { return pool.stats(); }
+        void wait(task_id id) { pool.wait(id); }
+        void stop_forever(task_id id) { pool.stop_forever(id); }
+        void configure(std::string_view name, const name_options& options) { pool.configure(name, options); }
+        void wait_all(std::string_view name) { pool.wait_all(name); }
+        std::size_t cancel(std::string_view name) { return pool.cancel(name); }
+        bool cancel(task_id id) { return pool.cancel(id); }
+        bool set_deadline(task_id id, std::chrono::steady_clock::time_point deadline) { return pool.set_deadline(id, deadline); }
 
-        template <typename Fn, typename... Args> std::thread::id start(std::string name, Fn&& fn, Args&&... args) { return pool.start(name, std::forward<Fn>(fn), std::forward<Args>(args)...); }
-        template <typename Fn, typename... Args> std::thread::id start_wait(std::string name, std::chrono::milliseconds wait_time, Fn&& fn, Args&&... args)
+        template <typename Fn, typename... Args>
+            requires(!std::is_same_v<std::decay_t<Fn>, placement>)
+        task_id start(std::string_view name, Fn&& fn, Args&&... args)
+        {
+            return pool.start(name, std::forward<Fn>(fn), std::forward<Args>(args)...);
+        }
+        template <typename Fn, typename... Args> task_id start(std::string_view name, const placement& where, Fn&& fn, Args&&... args)
+        {
+            return pool.start(name, where, std::forward<Fn>(fn), std::forward<Args>(args)...);
+        }
+        template <typename Fn, typename... Args> task_id start_until(std::string_view name, std::chrono::steady_clock::time_point deadline, Fn&& fn, Args&&... args)
+        {
+            return pool.start_until(name, deadline, std::forward<Fn>(fn), std::forward<Args>(args)...);
+        }
+        template <typename Fn, typename... Args> task_id start_for(std::string_view name, std::chrono::milliseconds timeout, Fn&& fn, Args&&... args)
+        {
+            return pool.start_for(name, timeout, std::forward<Fn>(fn), std::forward<Args>(args)...);
+        }
+        template <typename Fn, typename... Args> task_id start_wait(std::string_view name, std::chrono::milliseconds wait_time, Fn&& fn, Args&&... args)
         {
             return pool.start_wait(name, wait_time, std::forward<Fn>(fn), std::forward<Args>(args)...);
         }
-        template <typename Fn, typename... Args> std::thread::id start_forever(std::string name, std::chrono::milliseconds interval, Fn&& fn, Args&&... args)
+        template <typename Fn, typename... Args> task_id start_wait(std::string_view name, const placement& where, std::chrono::milliseconds wait_time, Fn&& fn, Args&&... args)
+        {
+            return pool.start_wait(name, where, wait_time, std::forward<Fn>(fn), std::forward<Args>(args)...);
+        }
+        template <typename Fn, typename... Args> task_id start_forever(std::string_view name, std::chrono::milliseconds interval, Fn&& fn, Args&&... args)
         {
             return pool.start_forever(name, interval, std::forward<Fn>(fn), std::forward<Args>(args)...);
         }
-        template <typename Fn, typename... Args> std::thread::id start_forever_high_resolution(std::string name, std::chrono::milliseconds interval, Fn&& fn, Args&&... args)
+        template <typename Fn, typename... Args> task_id start_forever(std::string_view name, const placement& where, std::chrono::milliseconds interval, Fn&& fn, Args&&... args)
+        {
+            return pool.start_forever(name, where, interval, std::forward<Fn>(fn), std::forward<Args>(args)...);
+        }
+        template <typename Fn, typename... Args> task_id start_forever_high_resolution(std::string_view name, std::chrono::milliseconds interval, Fn&& fn, Args&&... args)
         {
             return pool.start_forever_high_resolution(name, interval, std::forward<Fn>(fn), std::forward<Args>(args)...);
         }
-        template <typename Fn, typename... Args> std::thread::id start_forever_system_perf(std::string name, std::chrono::milliseconds interval, Fn&& fn, Args&&... args)
+        template <typename Fn, typename... Args> task_id start_forever_system_perf(std::string_view name, std::chrono::milliseconds interval, Fn&& fn, Args&&... args)
         {
             return pool.start_forever_system_perf(name, interval, std::forward<Fn>(fn), std::forward<Args>(args)...);
         }
     };
 
-    bool has(std::string name)
+    inline bool has(std::string_view name)
     {
-        return !stdex::detail::default_pool.names(name).empty();
+        return stdex::detail::default_pool.has(name);
     }
-    bool has(std::thread::id id)
+    inline bool has(task_id id)
     {
-        return stdex::detail::default_pool.id(id) != nullptr;
+        return stdex::detail::default_pool.has(id);
     }
-    std::shared_ptr<stdex::detail::async_task> id(std::thread::id id)
+    inline std::size_t count(std::string_view name)
+    {
+        return stdex::detail::default_pool.count(name);
+    }
+    inline std::optional<jitter_stats> jitter(task_id id)
+    {
+        return stdex::detail::default_pool.jitter(id);
+    }
+    inline pool_stats stats()
+    {
+        return stdex::detail::default_pool.stats();
+    }
+    inline void enable_stats(bool enabled)
+    {
+        stdex::detail::default_pool.enable_stats(enabled);
+    }
+    inline std::shared_ptr<const stdex::detail::async_task> id(task_id id)
     {
         return stdex::detail::default_pool.id(id);
     }
-    void stop_forever(std::thread::id id)
+    inline void stop_forever(task_id id)
     {
         stdex::detail::default_pool.stop_forever(id);
     }
-    template <typename Fn, typename... Args> std::thread::id start(std::string name, Fn&& fn, Args&&... args)
+    inline void configure(std::string_view name, const name_options& options)
+    {
+        stdex::detail::default_pool.configure(name, options);
+    }
+    inline void wait_all(std::string_view name)
+    {
+        stdex::detail::default_pool.wait_all(name);
+    }
+    inline std::size_t cancel(std::string_view name)
+    {
+        return stdex::detail::default_pool.cancel(name);
+    }
+    inline bool cancel(task_id id)
+    {
+        return stdex::detail::default_pool.cancel(id);
+    }
+    inline bool set_deadline(task_id id, std::chrono::steady_clock::time_point deadline)
+    {
+        return stdex::detail::default_pool.set_deadline(id, deadline);
+    }
+    template <typename Fn, typename... Args>
+        requires(!std::is_same_v<std::decay_t<Fn>, placement>)
+    task_id start(std::string_view name, Fn&& fn, Args&&... args)
     {
         return stdex::detail::default_pool.start(name, std::forward<Fn>(fn), std::forward<Args>(args)...);
     }
-    template <typename Fn, typename... Args> std::thread::id start_wait(std::string name, std::chrono::milliseconds wait_time, Fn&& fn, Args&&... args)
+    template <typename Fn, typename... Args> task_id start(std::string_view name, const placement& where, Fn&& fn, Args&&... args)
+    {
+        return stdex::detail::default_pool.start(name, where, std::forward<Fn>(fn), std::forward<Args>(args)...);
+    }
+    template <typename Fn, typename... Args> task_id start_until(std::string_view name, std::chrono::steady_clock::time_point deadline, Fn&& fn, Args&&... args)
+    {
+        return stdex::detail::default_pool.start_until(name, deadline, std::forward<Fn>(fn), std::forward<Args>(args)...);
+    }
+    template <typename Fn, typename... Args> task_id start_for(std::string_view name, std::chrono::milliseconds timeout, Fn&& fn, Args&&... args)
+    {
+        return stdex::detail::default_pool.start_for(name, timeout, std::forward<Fn>(fn), std::forward<Args>(args)...);
+    }
+    template <typename Fn, typename... Args> task_id start_wait(std::string_view name, std::chrono::milliseconds wait_time, Fn&& fn, Args&&... args)
     {
         return stdex::detail::default_pool.start_wait(name, wait_time, std::forward<Fn>(fn), std::forward<Args>(args)...);
     }
-    template <typename Fn, typename... Args> std::thread::id start_forever(std::string name, std::chrono::milliseconds interval, Fn&& fn, Args&&... args)
+    template <typename Fn, typename... Args> task_id start_wait(std::string_view name, const placement& where, std::chrono::milliseconds wait_time, Fn&& fn, Args&&... args)
+    {
+        return stdex::detail::default_pool.start_wait(name, where, wait_time, std::forward<Fn>(fn), std::forward<Args>(args)...);
+    }
+    template <typename Fn, typename... Args> task_id start_forever(std::string_view name, std::chrono::milliseconds interval, Fn&& fn, Args&&... args)
     {
         return stdex::detail::default_pool.start_forever(name, interval, std::forward<Fn>(fn), std::forward<Args>(args)...);
     }
-    template <typename Fn, typename... Args> std::thread::id start_forever_high_resolution(std::string name, std::chrono::milliseconds interval, Fn&& fn, Args&&... args)
+    template <typename Fn, typename... Args> task_id start_forever(std::string_view name, const placement& where, std::chrono::milliseconds interval, Fn&& fn, Args&&... args)
+    {
+        return stdex::detail::default_pool.start_forever(name, where, interval, std::forward<Fn>(fn), std::forward<Args>(args)...);
+    }
+    template <typename Fn, typename... Args> task_id start_forever_high_resolution(std::string_view name, std::chrono::milliseconds interval, Fn&& fn, Args&&... args)
     {
         return stdex::detail::default_pool.start_forever_high_resolution(name, interval, std::forward<Fn>(fn), std::forward<Args>(args)...);
     }
-    template <typename Fn, typename... Args> std::thread::id start_forever_system_perf(std::string name, std::chrono::milliseconds interval, Fn&& fn, Args&&... args)
+    template <typename Fn, typename... Args> task_id start_forever_system_perf(std::string_view name, std::chrono::milliseconds interval, Fn&& fn, Args&&... args)
     {
         return stdex::detail::default_pool.start_forever_system_perf(name, interval, std::forward<Fn>(fn), std::forward<Args>(args)...);
     }
@@ -1,21 +1,144 @@
 #pragma once
+#include <condition_variable>
+#include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include <self_releasing_async.hpp>
 
 namespace stdex
 {
+    // what a submission does while the previous job is still running
+    enum class overlap_policy
+    {
+        reject,   // drop it, the running job's result is all there is
+        coalesce, // keep only the newest one and run it right after the current job finishes
+    };
+
+    enum class submit_status
+    {
+        started,   // nothing was running, the job was handed to the pool
+        coalesced, // queued as the trailing rerun, replacing any earlier queued job
+        rejected,  // dropped under overlap_policy::reject
+    };
+
+    template <typename R> struct submission
+    {
+        submit_status status;
+        std::shared_future<R> future; // the run that will reflect this submission, the running one when rejected
+    };
+
+    // at most one job at a time on a shared async_pool, for "recompute when inputs change" work
     template <typename R> class single_async_executor
     {
-        std::future<R> future;
+        detail::async_pool& pool;
+        overlap_policy policy;
         std::mutex mutex;
+        std::condition_variable idle;
+        bool running = false;
+        std::shared_future<R> current;
+        // every coalesced submission shares the trailing run's promise, only the newest job is kept
+        detail::task_function pending;
+        std::shared_ptr<std::promise<R>> pending_promise;
+        std::shared_future<R> pending_future;
+
+    private:
+        template <typename Body> static void fulfil(std::promise<R>& promise, Body& body)
+        {
+            try
+            {
+                if constexpr (std::is_void_v<R>)
+                {
+                    body();
+                    promise.set_value();
+                }
+                else
+                    promise.set_value(body());
+            }
+            catch (...)
+            {
+                promise.set_exception(std::current_exception());
+            }
+        }
+
+        // runs the accepted job and then every trailing rerun queued meanwhile on the same worker
+        void drain(detail::task_function job)
+        {
+            for (;;)
+            {
+                job();
+                std::lock_guard lock(mutex);
+                if (!pending)
+                {
+                    running = false;
+                    idle.notify_all();
+                    return;
+                }
+                job = std::move(pending);
+                pending_promise.reset();
+                current = std::exchange(pending_future, {});
+            }
+        }
+
+    public:
+        explicit single_async_executor(overlap_policy policy = overlap_policy::reject, detail::async_pool& pool = detail::default_pool)
+            : pool(pool), policy(policy)
+        {
+        }
+        ~single_async_executor() { wait(); }
+        single_async_executor(const single_async_executor&) = delete;
+        single_async_executor& operator=(const single_async_executor&) = delete;
 
     public:
-        template <typename Function, typename... Args> void submit_exclusive(Function&& f, Args&&... args)
+        template <typename Function, typename... Args> submission<R> submit(Function&& f, Args&&... args)
+        {
+            auto body = [f = std::forward<Function>(f), ... args = std::forward<Args>(args)]() mutable -> R { return std::invoke(std::move(f), std::move(args)...); };
+
+            std::unique_lock lock(mutex);
+            if (running)
+            {
+                if (policy == overlap_policy::reject)
+                    return { submit_status::rejected, current };
+                if (pending_promise == nullptr)
+                {
+                    pending_promise = std::make_shared<std::promise<R>>();
+                    pending_future = pending_promise->get_future().share();
+                }
+                pending = [promise = pending_promise, body = std::move(body)]() mutable { fulfil(*promise, body); };
+                return { submit_status::coalesced, pending_future };
+            }
+            running = true;
+            auto promise = std::make_shared<std::promise<R>>();
+            current = promise->get_future().share();
+            auto future = current;
+            lock.unlock();
+            pool.post([this, job = detail::task_function([promise, body = std::move(body)]() mutable { fulfil(*promise, body); })]() mutable { drain(std::move(job)); });
+            return { submit_status::started, std::move(future) };
+        }
+        template <typename Function, typename... Args> submit_status submit_exclusive(Function&& f, Args&&... args)
+        {
+            return submit(std::forward<Function>(f), std::forward<Args>(args)...).status;
+        }
+
+        bool busy()
+        {
+            std::lock_guard lock(mutex);
+            return running;
+        }
+        // the most recently started run, invalid before the first submission
+        std::shared_future<R> last()
+        {
+            std::lock_guard lock(mutex);
+            return current;
+        }
+        // blocks until the running job and any trailing rerun finished
+        void wait()
         {
-            std::lock_guard<std::mutex> lock(mutex);
-            if (future.valid() && future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
-                return;
-            future = std::async(std::launch::async, std::forward<Function>(f), std::forward<Args>(args)...);
+            std::unique_lock lock(mutex);
+            idle.wait(lock, [this] { return !running; });
         }
     };
 } // namespace stdex
@@ -0,0 +1,241 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+namespace stdex
+{
+    // occupancy of a pool's arena, see async_pool::stats
+    struct arena_stats
+    {
+        std::size_t slabs = 0;
+        std::size_t reserved_bytes = 0;       // slab memory, kept until the pool and every block it handed out are gone
+        std::size_t blocks_in_use = 0;
+        std::size_t bytes_in_use = 0;         // rounded up to the size classes
+        std::size_t oversize_allocations = 0; // since the pool started, bigger than the largest class and sent to operator new
+    };
+
+    namespace detail
+    {
+        // size classed freelists for the small objects a pool allocates per task: control blocks, promise states,
+        // closures, registry nodes. blocks come from 64 KiB slabs that are recycled, never returned to the system
+        // while the pool lives. every thread allocates from one of a few shards under an uncontended lock, a free
+        // is a lock-free push onto the owning shard. blocks may outlive the pool (futures and control blocks
+        // handed out by queries), the arena goes away with the last of them.
+        class slab_arena
+        {
+        public:
+            static constexpr std::size_t slab_size = 64 * 1024;
+            static constexpr std::size_t min_block = 32;
+            static constexpr std::size_t class_count = 5; // 32, 64, 128, 256, 512
+            static constexpr std::size_t max_block = min_block << (class_count - 1);
+            static constexpr std::size_t shard_count = 8;
+
+        private:
+            struct free_block
+            {
+                free_block* next;
+            };
+            struct size_class;
+            // at the start of every slab, a block finds it by masking its address
+            struct slab_header
+            {
+                slab_arena* owner;
+                size_class* home;
+                std::size_t block_size;
+                std::atomic<std::size_t> refs = { 1 }; // blocks handed out, plus one until the arena is closed
+                slab_header* next = nullptr;           // every slab of the arena
+            };
+            static constexpr std::size_t header_size = (sizeof(slab_header) + 63) / 64 * 64;
+
+            struct alignas(64) size_class
+            {
+                std::mutex mutex;
+                free_block* local = nullptr; // guarded by mutex
+                std::byte* bump = nullptr;   // the rest of the newest slab, guarded by mutex
+                std::byte* bump_end = nullptr;
+                slab_header* current = nullptr;
+                alignas(64) std::atomic<free_block*> remote = { nullptr }; // frees from any thread, taken whole
+            };
+            struct shard
+            {
+                std::array<size_class, class_count> classes;
+            };
+
+            std::array<shard, shard_count> shards;
+            std::atomic<slab_header*> slabs = { nullptr };
+            std::atomic<std::size_t> alive = { 1 }; // slabs not yet freed, plus one until the arena is closed
+            std::atomic<std::size_t> oversize = { 0 };
+
+        private:
+            static std::size_t class_of(std::size_t size) noexcept
+            {
+                std::size_t index = 0;
+                for (auto block = min_block; block < size; block *= 2)
+                    index++;
+                return index;
+            }
+            static shard& local_shard(slab_arena& arena) noexcept
+            {
+                static std::atomic<std::size_t> next_thread = { 0 };
+                static thread_local const std::size_t index = next_thread.fetch_add(1, std::memory_order_relaxed) % shard_count;
+                return arena.shards[index];
+            }
+            static slab_header& header_of(void* block) noexcept
+            {
+                return *reinterpret_cast<slab_header*>(reinterpret_cast<std::uintptr_t>(block) & ~(slab_size - 1));
+            }
+            static bool oversized(std::size_t size, std::size_t alignment) noexcept { return size > max_block || alignment > alignof(std::max_align_t); }
+
+            // under the class lock
+            void open_slab(size_class& target, std::size_t block_size)
+            {
+                auto memory = static_cast<std::byte*>(::operator new(slab_size, std::align_val_t(slab_size)));
+                auto header = ::new (memory) slab_header{ this, &target, block_size };
+                alive.fetch_add(1, std::memory_order_relaxed);
+                header->next = slabs.load(std::memory_order_relaxed);
+                while (!slabs.compare_exchange_weak(header->next, header, std::memory_order_release, std::memory_order_relaxed))
+                    ;
+                target.current = header;
+                target.bump = memory + header_size;
+                target.bump_end = memory + header_size + (slab_size - header_size) / block_size * block_size;
+            }
+            void* take(std::size_t size)
+            {
+                auto block_size = min_block << class_of(size);
+                auto& target = local_shard(*this).classes[class_of(size)];
+                std::lock_guard lock(target.mutex);
+                if (target.local == nullptr)
+                    target.local = target.remote.exchange(nullptr, std::memory_order_acquire);
+                if (auto block = target.local; block != nullptr)
+                {
+                    target.local = block->next;
+                    header_of(block).refs.fetch_add(1, std::memory_order_relaxed);
+                    return block;
+                }
+                if (target.bump == target.bump_end)
+                    open_slab(target, block_size);
+                auto block = target.bump;
+                target.bump += block_size;
+                target.current->refs.fetch_add(1, std::memory_order_relaxed);
+                return block;
+            }
+            // pushed before the reference is dropped, the slab and its arena stay alive until the push is done
+            static void give_back(void* pointer) noexcept
+            {
+                auto& header = header_of(pointer);
+                auto block = ::new (pointer) free_block{ header.home->remote.load(std::memory_order_relaxed) };
+                while (!header.home->remote.compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed))
+                    ;
+                if (header.refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    header.owner->drop_slab(header);
+            }
+            void drop_slab(slab_header& header) noexcept
+            {
+                header.~slab_header();
+                ::operator delete(static_cast<void*>(&header), std::align_val_t(slab_size));
+                release();
+            }
+            void release() noexcept
+            {
+                if (alive.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    delete this;
+            }
+
+            slab_arena() = default;
+            ~slab_arena() = default;
+
+        public:
+            // called by the owner instead of delete: slabs without live blocks go right away, the rest with their last block
+            struct closer
+            {
+                void operator()(slab_arena* arena) const noexcept { arena->close(); }
+            };
+            static std::unique_ptr<slab_arena, closer> create() { return std::unique_ptr<slab_arena, closer>(new slab_arena); }
+
+            slab_arena(const slab_arena&) = delete;
+            slab_arena& operator=(const slab_arena&) = delete;
+
+            void close() noexcept
+            {
+                // a slab can only be freed once its arena reference is dropped, so the links ahead are still valid
+                for (auto header = slabs.load(std::memory_order_acquire); header != nullptr;)
+                {
+                    auto next = header->next;
+                    if (header->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        drop_slab(*header);
+                    header = next;
+                }
+                release();
+            }
+
+            // a null arena stands for operator new, so allocators can be default constructed
+            static void* allocate(slab_arena* arena, std::size_t size, std::size_t alignment)
+            {
+                if (arena == nullptr || oversized(size, alignment))
+                {
+                    if (arena != nullptr)
+                        arena->oversize.fetch_add(1, std::memory_order_relaxed);
+                    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                        return ::operator new(size, std::align_val_t(alignment));
+                    return ::operator new(size);
+                }
+                return arena->take(size);
+            }
+            // never touches the arena itself, it may already be closed
+            static void deallocate(slab_arena* arena, void* pointer, std::size_t size, std::size_t alignment) noexcept
+            {
+                if (arena != nullptr && !oversized(size, alignment))
+                    give_back(pointer);
+                else if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                    ::operator delete(pointer, std::align_val_t(alignment));
+                else
+                    ::operator delete(pointer);
+            }
+
+            // walks the slab list without stopping allocations, counts may be a few blocks off
+            arena_stats stats() const noexcept
+            {
+                arena_stats result;
+                for (auto header = slabs.load(std::memory_order_acquire); header != nullptr; header = header->next)
+                {
+                    auto blocks = header->refs.load(std::memory_order_relaxed) - 1;
+                    result.slabs++;
+                    result.blocks_in_use += blocks;
+                    result.bytes_in_use += blocks * header->block_size;
+                }
+                result.reserved_bytes = result.slabs * slab_size;
+                result.oversize_allocations = oversize.load(std::memory_order_relaxed);
+                return result;
+            }
+        };
+        using slab_arena_ptr = std::unique_ptr<slab_arena, slab_arena::closer>;
+
+        // std allocator over a slab_arena, it travels with the containers and shared states it is given to
+        template <typename T> class arena_allocator
+        {
+            template <typename U> friend class arena_allocator;
+            slab_arena* arena = nullptr;
+
+        public:
+            using value_type = T;
+            using propagate_on_container_copy_assignment = std::true_type;
+            using propagate_on_container_move_assignment = std::true_type;
+            using propagate_on_container_swap = std::true_type;
+
+            arena_allocator() noexcept = default;
+            explicit arena_allocator(slab_arena* arena) noexcept : arena(arena) {}
+            template <typename U> arena_allocator(const arena_allocator<U>& other) noexcept : arena(other.arena) {}
+
+            T* allocate(std::size_t n) { return static_cast<T*>(slab_arena::allocate(arena, n * sizeof(T), alignof(T))); }
+            void deallocate(T* pointer, std::size_t n) noexcept { slab_arena::deallocate(arena, pointer, n * sizeof(T), alignof(T)); }
+
+            template <typename U> bool operator==(const arena_allocator<U>& other) const noexcept { return arena == other.arena; }
+        };
+    } // namespace detail
+} // namespace stdex
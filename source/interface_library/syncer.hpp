@@ -1,76 +1,512 @@
 #pragma once
 #include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <mutex>
+#include <new>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <atomic_wait.hpp>
 
 namespace stdex
 {
-    template <typename T, bool read_is_lock_free = false> class syncer
+    namespace detail
     {
-        T cache;
+        // rebuilds target from args without a temporary when that cannot leave it destroyed
+        template <typename T, typename... Args> void construct_over(T& target, Args&&... args)
+        {
+            if constexpr (std::is_nothrow_constructible_v<T, Args...>)
+            {
+                target.~T();
+                ::new (static_cast<void*>(std::addressof(target))) T(std::forward<Args>(args)...);
+            }
+            else
+                target = T(std::forward<Args>(args)...);
+        }
+
+        // publishers notify once per value, readers spin on their own check a while and then park
+        class change_signal
+        {
+            wait_event event;
+            std::atomic<std::uint32_t> spins = { 64 };
+
+        public:
+            void notify() noexcept { event.notify_all(); }
+            void set_spin_count(std::uint32_t count) noexcept { spins.store(count, std::memory_order_relaxed); }
+
+            template <typename Ready> bool await(Ready&& ready, std::stop_token& st, const wait_clock::time_point* deadline)
+            {
+                return event.await(std::forward<Ready>(ready), spins.load(std::memory_order_relaxed), st, deadline);
+            }
+            template <typename Scheduler, typename Ready> auto await_async(Scheduler& scheduler, Ready ready)
+            {
+                return event_awaiter(event, scheduler, [ready = std::move(ready)]() mutable -> std::optional<bool> {
+                    if (ready())
+                        return true;
+                    return std::nullopt;
+                });
+            }
+        };
+
+        // blocking reads for anything with try_sync / changed and a change_signal reachable through signal().
+        // each returns false when st was stopped or the deadline passed before a new value arrived.
+        template <typename Derived, typename T> class sync_waits
+        {
+            Derived& self() noexcept { return static_cast<Derived&>(*this); }
+
+            template <typename Clock, typename Duration> static wait_clock::time_point to_wait_clock(std::chrono::time_point<Clock, Duration> deadline)
+            {
+                return wait_clock::now() + std::chrono::ceil<wait_clock::duration>(deadline - Clock::now());
+            }
+
+        public:
+            bool wait_sync(T& value, std::stop_token st = {}) { return self().signal().await([&] { return self().try_sync(value); }, st, nullptr); }
+            template <typename Rep, typename Period> bool wait_sync_for(T& value, std::chrono::duration<Rep, Period> timeout, std::stop_token st = {})
+            {
+                return wait_sync_until(value, wait_clock::now() + std::chrono::ceil<wait_clock::duration>(timeout), st);
+            }
+            template <typename Clock, typename Duration> bool wait_sync_until(T& value, std::chrono::time_point<Clock, Duration> deadline, std::stop_token st = {})
+            {
+                auto steady = to_wait_clock(deadline);
+                return self().signal().await([&] { return self().try_sync(value); }, st, &steady);
+            }
+
+            // waits for a new value without consuming it, for readers that take it through a view or snapshot
+            bool wait_changed(std::stop_token st = {}) { return self().signal().await([&] { return self().changed(); }, st, nullptr); }
+            template <typename Clock, typename Duration> bool wait_changed_until(std::chrono::time_point<Clock, Duration> deadline, std::stop_token st = {})
+            {
+                auto steady = to_wait_clock(deadline);
+                return self().signal().await([&] { return self().changed(); }, st, &steady);
+            }
+
+            // co_await forms of wait_sync / wait_changed, the coroutine is resumed on scheduler if it has to wait
+            template <typename Scheduler> auto wait_sync_async(T& value, Scheduler& scheduler)
+            {
+                return self().signal().await_async(scheduler, [this, &value] { return self().try_sync(value); });
+            }
+            template <typename Scheduler> auto wait_changed_async(Scheduler& scheduler)
+            {
+                return self().signal().await_async(scheduler, [this] { return self().changed(); });
+            }
+
+            // how many times a wait rechecks before it parks, zero parks right away
+            void set_spin_count(std::uint32_t count) noexcept { self().signal().set_spin_count(count); }
+        };
+    } // namespace detail
+
+    // copying readers need a copyable T, publishing only needs T to be movable or constructible in place.
+    // move-only values are read with try_take or visited in place with with
+    template <typename T, bool read_is_lock_free = false> class syncer : public detail::sync_waits<syncer<T, read_is_lock_free>, T>
+    {
+        friend class detail::sync_waits<syncer, T>;
+
+        T cache = {};
         std::mutex cache_mutex;
         std::atomic<bool> no_changed_flag = { true };
+        detail::change_signal changes;
 
-    public:
-        static_assert(std::is_copy_constructible_v<T>, "T must be copy constructible");
-        static_assert(std::is_copy_assignable_v<T>, "T must be copy assignable");
+        detail::change_signal& signal() noexcept { return changes; }
 
+    public:
+        bool changed() const noexcept { return !no_changed_flag.load(std::memory_order_relaxed); }
+        // a plain load first, so polling an unchanged value never writes the shared line. the flag is consumed
+        // under the lock, so a change is either copied here or taken by try_take, never both
         bool try_sync(T& value)
+            requires std::is_copy_assignable_v<T>
         {
-            if (no_changed_flag.exchange(true))
+            if (!changed())
                 return false;
             std::lock_guard lock(cache_mutex);
+            if (no_changed_flag.exchange(true))
+                return false;
             value = cache;
             return true;
         }
+        // moves the latest value out, the held one stays moved-from until the next set
+        bool try_take(T& value)
+            requires std::is_move_assignable_v<T>
+        {
+            if (!changed())
+                return false;
+            std::lock_guard lock(cache_mutex);
+            if (no_changed_flag.exchange(true))
+                return false;
+            value = std::move(cache);
+            return true;
+        }
         T get()
+            requires std::is_copy_constructible_v<T>
         {
             std::lock_guard lock(cache_mutex);
             return cache;
         }
-        void set(const T& value)
+        // fn(const T&) on the held value under the lock, returns what fn returns. keep fn short, setters wait on it
+        template <typename Fn> decltype(auto) with(Fn&& fn)
         {
             std::lock_guard lock(cache_mutex);
-            cache = value;
-            no_changed_flag.store(false);
+            return std::forward<Fn>(fn)(std::as_const(cache));
+        }
+        void set(const T& value) { emplace(value); }
+        void set(T&& value) { emplace(std::move(value)); }
+        template <typename... Args> void emplace(Args&&... args)
+        {
+            {
+                std::lock_guard lock(cache_mutex);
+                detail::construct_over(cache, std::forward<Args>(args)...);
+                no_changed_flag.store(false);
+            }
+            changes.notify();
         }
     };
-    template <typename T> class syncer<T, true>
+    // any number of readers, each tracking the last version it saw. values live in buffer_count slots;
+    // a reader pins the current slot while it copies or views it and the writer only fills unpinned ones,
+    // so reads are never torn and never block the writer unless every spare slot is held by a reader.
+    template <typename T, std::size_t buffer_count = 4> class versioned_syncer
     {
-        T cache[2] = {};
-        std::atomic<bool> readyed_flag = { false };
-        std::atomic_flag no_changed_flag = ATOMIC_FLAG_INIT;
+        static_assert(buffer_count >= 2 && buffer_count <= 256, "versioned_syncer needs a spare buffer to write into");
+
+        struct alignas(64) slot
+        {
+            T value = {};
+            std::atomic<std::uint32_t> pins = { 0 };
+        };
+
+        // version << 8 | slot index, readers learn both with one load
+        static constexpr unsigned index_bits = 8;
+        static std::size_t index_of(std::uint64_t state) noexcept { return static_cast<std::size_t>(state & ((1u << index_bits) - 1)); }
+
+        slot slots[buffer_count];
+        alignas(64) std::atomic<std::uint64_t> current = { 0 };
         std::mutex setting_mutex;
+        detail::change_signal changes;
 
     public:
-        static_assert(std::is_copy_constructible_v<T>, "T must be copy constructible");
-        static_assert(std::is_copy_assignable_v<T>, "T must be copy assignable");
+        // a pinned slot, the writer leaves it alone until the view is destroyed
+        class view
+        {
+            slot* pinned;
+            std::uint64_t pinned_version;
+
+        public:
+            view(slot& target, std::uint64_t version) noexcept : pinned(&target), pinned_version(version) {}
+            view(view&& other) noexcept : pinned(std::exchange(other.pinned, nullptr)), pinned_version(other.pinned_version) {}
+            view& operator=(view&& other) noexcept
+            {
+                std::swap(pinned, other.pinned);
+                std::swap(pinned_version, other.pinned_version);
+                return *this;
+            }
+            ~view()
+            {
+                if (pinned != nullptr)
+                    pinned->pins.fetch_sub(1, std::memory_order_release);
+            }
+
+            const T& operator*() const noexcept { return pinned->value; }
+            const T* operator->() const noexcept { return &pinned->value; }
+            std::uint64_t version() const noexcept { return pinned_version; }
+        };
+
+        class reader : public detail::sync_waits<reader, T>
+        {
+            friend class detail::sync_waits<reader, T>;
+
+            versioned_syncer& source;
+            std::uint64_t seen = 0;
+
+            detail::change_signal& signal() noexcept { return source.changes; }
+
+        public:
+            explicit reader(versioned_syncer& syncer) noexcept : source(syncer) {}
+
+            bool changed() const noexcept { return source.version() != seen; }
+            std::uint64_t version() const noexcept { return seen; }
 
-        syncer() { no_changed_flag.test_and_set(std::memory_order_release); }
+            bool try_sync(T& value)
+                requires std::is_copy_assignable_v<T>
+            {
+                if (!changed())
+                    return false;
+                auto latest = source.get_view();
+                value = *latest;
+                seen = latest.version();
+                return true;
+            }
+            // a view of the latest value when it is newer than the last one this reader saw
+            std::optional<view> try_view()
+            {
+                if (!changed())
+                    return std::nullopt;
+                auto latest = source.get_view();
+                seen = latest.version();
+                return latest;
+            }
+        };
 
     public:
-        bool try_sync(T& value) noexcept
+        reader make_reader() noexcept { return reader(*this); }
+
+        std::uint64_t version() const noexcept { return current.load(std::memory_order_acquire) >> index_bits; }
+
+        view get_view() noexcept
+        {
+            for (;;)
+            {
+                auto state = current.load(std::memory_order_seq_cst);
+                auto& target = slots[index_of(state)];
+                target.pins.fetch_add(1, std::memory_order_seq_cst);
+                // pinned before the slot stopped being current, so the writer will see the pin
+                if (current.load(std::memory_order_seq_cst) == state)
+                    return view(target, state >> index_bits);
+                target.pins.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+        T get()
+            requires std::is_copy_constructible_v<T>
+        {
+            return *get_view();
+        }
+
+        void set(const T& value) { emplace(value); }
+        void set(T&& value) { emplace(std::move(value)); }
+        template <typename... Args> void emplace(Args&&... args)
         {
-            if (no_changed_flag.test_and_set(std::memory_order_acquire))
+            {
+                std::lock_guard lock(setting_mutex);
+                auto state = current.load(std::memory_order_relaxed);
+                auto index = index_of(state);
+                auto next = index;
+                do
+                {
+                    next = (next + 1) % buffer_count;
+                    if (next == index)
+                        std::this_thread::yield(); // every spare slot is pinned, give the readers a moment
+                } while (next == index || slots[next].pins.load(std::memory_order_seq_cst) != 0);
+                detail::construct_over(slots[next].value, std::forward<Args>(args)...);
+                current.store((((state >> index_bits) + 1) << index_bits) | next, std::memory_order_seq_cst);
+            }
+            changes.notify();
+        }
+    };
+
+    // wait-free triple buffer for one consumer thread: the writer and the reader each own a buffer and swap it
+    // with the shared middle one, so neither ever touches the buffer the other is using. setters are serialized.
+    // try_sync / get / view move the consumer's buffer and must not be called from two threads, syncer<T, true>
+    // and versioned_syncer serve several readers.
+    template <typename T> class triple_buffer_syncer : public detail::sync_waits<triple_buffer_syncer<T>, T>
+    {
+        friend class detail::sync_waits<triple_buffer_syncer, T>;
+
+        static constexpr std::uint8_t index_mask = 0b011;
+        static constexpr std::uint8_t dirty_bit = 0b100;
+
+        T cache[3] = {};
+        alignas(64) std::atomic<std::uint8_t> middle = { 1 };
+        std::uint8_t back = 0;
+        std::mutex setting_mutex;
+        alignas(64) std::uint8_t front = 2;
+        detail::change_signal changes;
+
+    private:
+        detail::change_signal& signal() noexcept { return changes; }
+
+        // takes the middle buffer if the writer published since the last call
+        bool refresh() noexcept
+        {
+            if (!changed())
                 return false;
-            auto ready_index = readyed_flag.load(std::memory_order_consume);
+            front = middle.exchange(front, std::memory_order_acq_rel) & index_mask;
+            return true;
+        }
 
-            value = cache[ready_index];
+    public:
+        bool changed() const noexcept { return (middle.load(std::memory_order_relaxed) & dirty_bit) != 0; }
+        bool try_sync(T& value) noexcept
+            requires std::is_copy_assignable_v<T>
+        {
+            if (!refresh())
+                return false;
+            value = cache[front];
             return true;
         }
         T get() noexcept
+            requires std::is_copy_constructible_v<T>
         {
-            auto ready_index = readyed_flag.load(std::memory_order_seq_cst);
-            return cache[ready_index];
+            refresh();
+            return cache[front];
         }
-        void set(const T& value) noexcept
+        // the latest value without a copy, valid until this consumer's next try_sync / get / view
+        const T& view() noexcept
         {
-            std::lock_guard lock(setting_mutex);
-            const int target_index = 1 - readyed_flag.load(std::memory_order_relaxed);
+            refresh();
+            return cache[front];
+        }
+        void set(const T& value) { emplace(value); }
+        void set(T&& value) { emplace(std::move(value)); }
+        template <typename... Args> void emplace(Args&&... args)
+        {
+            {
+                std::lock_guard lock(setting_mutex);
+                detail::construct_over(cache[back], std::forward<Args>(args)...);
+                back = middle.exchange(back | dirty_bit, std::memory_order_acq_rel) & index_mask;
+            }
+            changes.notify();
+        }
+    };
 
-            cache[target_index] = value;
+    // lock-free reads from any number of threads: the value lives in a versioned_syncer and every read pins the
+    // slot it copies from, so get() never sees a value being written. like syncer<T>, a change is taken by the
+    // first try_sync that sees it, whichever thread that is. setters are serialized.
+    template <typename T> class syncer<T, true> : public detail::sync_waits<syncer<T, true>, T>
+    {
+        friend class detail::sync_waits<syncer, T>;
+
+        versioned_syncer<T> values;
+        alignas(64) std::atomic<bool> no_changed_flag = { true };
+        detail::change_signal changes;
+
+        detail::change_signal& signal() noexcept { return changes; }
+
+    public:
+        bool changed() const noexcept { return !no_changed_flag.load(std::memory_order_relaxed); }
+        // a plain load first, so polling an unchanged value never writes the shared line
+        bool try_sync(T& value)
+            requires std::is_copy_assignable_v<T>
+        {
+            if (!changed() || no_changed_flag.exchange(true, std::memory_order_acq_rel))
+                return false;
+            value = *values.get_view();
+            return true;
+        }
+        T get()
+            requires std::is_copy_constructible_v<T>
+        {
+            return values.get();
+        }
+        // the latest value pinned without a copy, the writer leaves it alone until the view is destroyed
+        typename versioned_syncer<T>::view view() noexcept { return values.get_view(); }
 
-            readyed_flag.store(target_index, std::memory_order_release);
-            no_changed_flag.clear(std::memory_order_release);
+        void set(const T& value) { emplace(value); }
+        void set(T&& value) { emplace(std::move(value)); }
+        template <typename... Args> void emplace(Args&&... args)
+        {
+            values.emplace(std::forward<Args>(args)...);
+            no_changed_flag.store(false, std::memory_order_release);
+            changes.notify();
+        }
+    };
+
+    // rcu style: every publish allocates a new immutable value and readers share it by reference count.
+    // nothing is ever copied, a snapshot stays valid for as long as the reader holds it.
+    template <typename T> class snapshot_syncer
+    {
+        struct node
+        {
+            T value;
+            std::uint64_t version;
+
+            template <typename... Args> explicit node(std::uint64_t version, Args&&... args) : value(std::forward<Args>(args)...), version(version) {}
+        };
+        using handle = std::shared_ptr<const node>;
+
+#if defined(__cpp_lib_atomic_shared_ptr)
+        std::atomic<handle> current;
+#else
+        handle current;
+        mutable std::mutex current_mutex;
+#endif
+        // readers check this before touching the shared pointer, an unchanged value costs them one load
+        alignas(64) std::atomic<std::uint64_t> latest_version = { 0 };
+        std::mutex setting_mutex;
+        detail::change_signal changes;
+
+    private:
+        handle load() const noexcept
+        {
+#if defined(__cpp_lib_atomic_shared_ptr)
+            return current.load(std::memory_order_acquire);
+#else
+            std::lock_guard lock(current_mutex);
+            return current;
+#endif
+        }
+        void store(handle next) noexcept
+        {
+#if defined(__cpp_lib_atomic_shared_ptr)
+            current.store(std::move(next), std::memory_order_release);
+#else
+            std::lock_guard lock(current_mutex);
+            current.swap(next);
+#endif
+        }
+        static std::shared_ptr<const T> value_of(handle held) noexcept
+        {
+            if (held == nullptr)
+                return nullptr;
+            auto& value = held->value;
+            return std::shared_ptr<const T>(std::move(held), &value);
+        }
+
+    public:
+        class reader : public detail::sync_waits<reader, T>
+        {
+            friend class detail::sync_waits<reader, T>;
+
+            snapshot_syncer& source;
+            std::uint64_t seen = 0;
+
+            detail::change_signal& signal() noexcept { return source.changes; }
+
+        public:
+            explicit reader(snapshot_syncer& syncer) noexcept : source(syncer) {}
+
+            bool changed() const noexcept { return source.version() != seen; }
+            std::uint64_t version() const noexcept { return seen; }
+
+            // the latest value when it is newer than the last one this reader saw, null otherwise
+            std::shared_ptr<const T> try_snapshot()
+            {
+                if (!changed())
+                    return nullptr;
+                auto held = source.load();
+                seen = held->version;
+                return value_of(std::move(held));
+            }
+            bool try_sync(T& value)
+                requires std::is_copy_assignable_v<T>
+            {
+                auto latest = try_snapshot();
+                if (latest == nullptr)
+                    return false;
+                value = *latest;
+                return true;
+            }
+        };
+
+    public:
+        reader make_reader() noexcept { return reader(*this); }
+
+        std::uint64_t version() const noexcept { return latest_version.load(std::memory_order_acquire); }
+        // null until the first publish
+        std::shared_ptr<const T> snapshot() const noexcept { return value_of(load()); }
+
+        void set(const T& value) { emplace(value); }
+        void set(T&& value) { emplace(std::move(value)); }
+        template <typename... Args> void emplace(Args&&... args)
+        {
+            {
+                std::lock_guard lock(setting_mutex);
+                auto version = latest_version.load(std::memory_order_relaxed) + 1;
+                store(std::make_shared<const node>(version, std::forward<Args>(args)...));
+                latest_version.store(version, std::memory_order_release);
+            }
+            changes.notify();
         }
     };
 } // namespace stdex
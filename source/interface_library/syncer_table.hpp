@@ -0,0 +1,249 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <type_traits>
+#include <utility>
+
+#include <syncer.hpp>
+
+namespace stdex
+{
+    namespace detail
+    {
+        // fixed arrays for a compile time extent, one heap block otherwise. elements are value initialised
+        template <typename U, std::size_t Extent> class table_array
+        {
+            std::array<U, Extent> items = {};
+
+        public:
+            explicit table_array(std::size_t) {}
+            U& operator[](std::size_t index) noexcept { return items[index]; }
+            const U& operator[](std::size_t index) const noexcept { return items[index]; }
+        };
+        template <typename U> class table_array<U, std::dynamic_extent>
+        {
+            std::unique_ptr<U[]> items;
+
+        public:
+            explicit table_array(std::size_t count) : items(new U[count]()) {}
+            U& operator[](std::size_t index) noexcept { return items[index]; }
+            const U& operator[](std::size_t index) const noexcept { return items[index]; }
+        };
+
+        constexpr std::size_t bits_extent(std::size_t extent, std::size_t per_bit) noexcept
+        {
+            return extent == std::dynamic_extent ? std::dynamic_extent : (extent + per_bit - 1) / per_bit;
+        }
+
+        // one triple_buffer_syncer per slot, laid out as arrays: the three value planes, the shared
+        // middle indexes, and the consumer's front indexes next to each other. a publish also sets the slot's bit
+        // in a dirty bitmap and, when that word was clean, the word's bit in a summary bitmap, so one summary word
+        // covers 4096 slots. the consumer walks the summary with plain loads and only exchanges the words and
+        // middles of slots that changed, a tick over an unchanged table writes nothing. any number of writers,
+        // serialised per slot by a stripe lock, and one consumer.
+        template <typename T, std::size_t Extent> class basic_syncer_table
+        {
+            static constexpr std::uint8_t index_mask = 0b011;
+            static constexpr std::uint8_t dirty_bit = 0b100;
+            static constexpr std::size_t word_bits = 64;
+            static constexpr std::size_t stripe_count = 64;
+
+            struct alignas(64) stripe
+            {
+                std::mutex mutex;
+            };
+
+            std::size_t count;
+            std::array<table_array<T, Extent>, 3> planes;
+            table_array<std::atomic<std::uint8_t>, Extent> middle;
+            table_array<std::uint8_t, Extent> back;  // guarded by the slot's stripe
+            table_array<std::uint8_t, Extent> front; // consumer only
+            table_array<std::atomic<std::uint64_t>, bits_extent(Extent, word_bits)> dirty;
+            table_array<std::atomic<std::uint64_t>, bits_extent(Extent, word_bits * word_bits)> summary;
+            std::array<stripe, stripe_count> stripes;
+            change_signal changes;
+
+        private:
+            static std::uint64_t bit(std::size_t index) noexcept { return std::uint64_t(1) << (index % word_bits); }
+            std::size_t word_count() const noexcept { return (count + word_bits - 1) / word_bits; }
+            std::size_t summary_count() const noexcept { return (word_count() + word_bits - 1) / word_bits; }
+
+            // only the writer that dirties a clean word touches the summary, only the one that dirties a clean
+            // summary word notifies. the consumer clears summary before words, so a bit set meanwhile is seen next time
+            void mark(std::size_t index) noexcept
+            {
+                auto word = index / word_bits;
+                if (dirty[word].fetch_or(bit(index), std::memory_order_release) != 0)
+                    return;
+                if (summary[word / word_bits].fetch_or(bit(word), std::memory_order_release) == 0)
+                    changes.notify();
+            }
+            // puts back the bits a throwing callback left unvisited
+            void remark(std::size_t word, std::uint64_t bits) noexcept
+            {
+                if (bits != 0 && dirty[word].fetch_or(bits, std::memory_order_release) == 0)
+                    summary[word / word_bits].fetch_or(bit(word), std::memory_order_release);
+            }
+            bool refresh(std::size_t index) noexcept
+            {
+                if (!changed(index))
+                    return false;
+                front[index] = middle[index].exchange(front[index], std::memory_order_acq_rel) & index_mask;
+                return true;
+            }
+
+            template <typename Clock, typename Duration> static wait_clock::time_point to_wait_clock(std::chrono::time_point<Clock, Duration> deadline)
+            {
+                return wait_clock::now() + std::chrono::ceil<wait_clock::duration>(deadline - Clock::now());
+            }
+
+        public:
+            explicit basic_syncer_table(std::size_t size)
+                : count(size), planes{ table_array<T, Extent>(size), table_array<T, Extent>(size), table_array<T, Extent>(size) }, middle(size), back(size),
+                  front(size), dirty(word_count()), summary(summary_count())
+            {
+                for (std::size_t i = 0; i < count; i++)
+                {
+                    middle[i].store(1, std::memory_order_relaxed);
+                    front[i] = 2;
+                }
+            }
+            basic_syncer_table(const basic_syncer_table&) = delete;
+            basic_syncer_table& operator=(const basic_syncer_table&) = delete;
+
+            std::size_t size() const noexcept { return count; }
+
+            // writers
+            void set(std::size_t index, const T& value) { emplace(index, value); }
+            void set(std::size_t index, T&& value) { emplace(index, std::move(value)); }
+            template <typename... Args> void emplace(std::size_t index, Args&&... args)
+            {
+                {
+                    std::lock_guard lock(stripes[index % stripe_count].mutex);
+                    auto& slot = back[index];
+                    construct_over(planes[slot][index], std::forward<Args>(args)...);
+                    slot = middle[index].exchange(slot | dirty_bit, std::memory_order_acq_rel) & index_mask;
+                }
+                mark(index);
+            }
+
+            // the consumer. changed() may report a slot that a single slot read already took
+            bool changed() const noexcept
+            {
+                for (std::size_t s = 0, end = summary_count(); s < end; s++)
+                    if (summary[s].load(std::memory_order_relaxed) != 0)
+                        return true;
+                return false;
+            }
+            bool changed(std::size_t index) const noexcept { return (middle[index].load(std::memory_order_relaxed) & dirty_bit) != 0; }
+
+            // fn(index, const T&) once for every slot published since it was last read, returns how many.
+            // the references are valid until the slot is read again
+            template <typename Fn> std::size_t for_each_changed(Fn&& fn)
+            {
+                std::size_t visited = 0;
+                for (std::size_t s = 0, end = summary_count(); s < end; s++)
+                {
+                    if (summary[s].load(std::memory_order_relaxed) == 0)
+                        continue;
+                    auto words = summary[s].exchange(0, std::memory_order_acquire);
+                    while (words != 0)
+                    {
+                        auto word = s * word_bits + static_cast<std::size_t>(std::countr_zero(words));
+                        words &= words - 1;
+                        auto bits = dirty[word].exchange(0, std::memory_order_acquire);
+                        try
+                        {
+                            while (bits != 0)
+                            {
+                                auto index = word * word_bits + static_cast<std::size_t>(std::countr_zero(bits));
+                                bits &= bits - 1;
+                                if (!refresh(index))
+                                    continue;
+                                visited++;
+                                fn(index, std::as_const(planes[front[index]][index]));
+                            }
+                        }
+                        catch (...)
+                        {
+                            remark(word, bits);
+                            if (words != 0)
+                                summary[s].fetch_or(words, std::memory_order_release);
+                            throw;
+                        }
+                    }
+                }
+                return visited;
+            }
+            // copies the changed slots into values, which holds size() elements
+            std::size_t try_sync(std::span<T> values)
+                requires std::is_copy_assignable_v<T>
+            {
+                return for_each_changed([&](std::size_t index, const T& value) { values[index] = value; });
+            }
+
+            // a single slot, for consumers that only look at a few
+            bool try_sync(std::size_t index, T& value) noexcept
+                requires std::is_copy_assignable_v<T>
+            {
+                if (!refresh(index))
+                    return false;
+                value = planes[front[index]][index];
+                return true;
+            }
+            T get(std::size_t index) noexcept
+                requires std::is_copy_constructible_v<T>
+            {
+                refresh(index);
+                return planes[front[index]][index];
+            }
+            const T& view(std::size_t index) noexcept
+            {
+                refresh(index);
+                return planes[front[index]][index];
+            }
+
+            // each returns false when st was stopped or the deadline passed before any slot changed
+            bool wait_changed(std::stop_token st = {}) { return changes.await([this] { return changed(); }, st, nullptr); }
+            template <typename Rep, typename Period> bool wait_changed_for(std::chrono::duration<Rep, Period> timeout, std::stop_token st = {})
+            {
+                auto steady = wait_clock::now() + std::chrono::ceil<wait_clock::duration>(timeout);
+                return changes.await([this] { return changed(); }, st, &steady);
+            }
+            template <typename Clock, typename Duration> bool wait_changed_until(std::chrono::time_point<Clock, Duration> deadline, std::stop_token st = {})
+            {
+                auto steady = to_wait_clock(deadline);
+                return changes.await([this] { return changed(); }, st, &steady);
+            }
+            template <typename Scheduler> auto wait_changed_async(Scheduler& scheduler)
+            {
+                return changes.await_async(scheduler, [this] { return changed(); });
+            }
+            void set_spin_count(std::uint32_t spins) noexcept { changes.set_spin_count(spins); }
+        };
+    } // namespace detail
+
+    // a table of latest values sized at run time, see detail::basic_syncer_table
+    template <typename T> class syncer_table : public detail::basic_syncer_table<T, std::dynamic_extent>
+    {
+    public:
+        explicit syncer_table(std::size_t size) : detail::basic_syncer_table<T, std::dynamic_extent>(size) {}
+    };
+
+    // the same with N slots held inline
+    template <typename T, std::size_t N> class syncer_array : public detail::basic_syncer_table<T, N>
+    {
+        static_assert(N != std::dynamic_extent);
+
+    public:
+        syncer_array() : detail::basic_syncer_table<T, N>(N) {}
+    };
+} // namespace stdex
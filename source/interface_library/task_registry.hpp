@@ -0,0 +1,270 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace stdex
+{
+    // issued by the pool, unique for the lifetime of the pool
+    enum class task_id : std::uint64_t
+    {
+        invalid = 0
+    };
+
+    namespace detail
+    {
+        struct registry_hook;
+        struct name_counters;
+        struct name_gate;
+
+        // interned task name, owned by the tasks of the name. the index only holds it weakly, unless the name was
+        // configured or has stats totals, and drops it when the last owner lets go. see task_registry::keep
+        struct task_name
+        {
+            std::string text;
+            std::atomic<std::size_t> live = { 0 };
+            std::mutex members_mutex;
+            registry_hook* members = nullptr;
+            std::shared_ptr<name_counters> counters; // guarded by members_mutex, only set when the owner collects stats
+            std::shared_ptr<name_gate> gate_owner;    // guarded by members_mutex, only set once the name was configured
+            std::atomic<name_gate*> gate = { nullptr }; // gate_owner for readers that do not take the lock
+        };
+
+        // intrusive links of the name -> tasks index, embedded in every registered task
+        struct registry_hook
+        {
+            task_name* name_entry = nullptr;
+            registry_hook* name_prev = nullptr;
+            registry_hook* name_next = nullptr;
+        };
+
+        // Task derives from registry_hook and has a task_id member named id.
+        // tasks are sharded by id, names by hash; has/count only read the interned name's live counter.
+        // Allocator only serves the id -> task nodes
+        template <typename Task, typename Allocator = std::allocator<std::byte>> class task_registry
+        {
+            static constexpr std::size_t shard_count = 64;
+
+            using task_map = std::unordered_map<task_id, std::shared_ptr<Task>, std::hash<task_id>, std::equal_to<task_id>,
+                                                typename std::allocator_traits<Allocator>::template rebind_alloc<std::pair<const task_id, std::shared_ptr<Task>>>>;
+            struct alignas(64) task_shard
+            {
+                std::shared_mutex mutex;
+                task_map tasks;
+            };
+            struct indexed_name
+            {
+                task_name* entry;
+                std::weak_ptr<task_name> weak;
+                std::shared_ptr<task_name> kept; // set by keep, the name then lives as long as the registry
+            };
+            struct alignas(64) name_shard
+            {
+                std::shared_mutex mutex;
+                std::unordered_map<std::string_view, indexed_name> names; // keys view the entry's text
+            };
+            // shared with the entries' deleters, which may run after the registry is gone
+            struct name_index
+            {
+                std::array<name_shard, shard_count> shards;
+
+                name_shard& shard_of(std::string_view name) noexcept { return shards[std::hash<std::string_view>{}(name) % shard_count]; }
+                void forget(task_name* entry) noexcept
+                {
+                    auto& shard = shard_of(entry->text);
+                    std::unique_lock lock(shard.mutex);
+                    // intern may already have put a new entry under the same text
+                    if (auto it = shard.names.find(entry->text); it != shard.names.end() && it->second.entry == entry)
+                        shard.names.erase(it);
+                }
+            };
+            // runs when the last owner drops the entry. no shared_ptr to an entry is ever released under a shard lock
+            struct name_release
+            {
+                std::weak_ptr<name_index> index;
+                void operator()(task_name* entry) const noexcept
+                {
+                    if (auto owner = index.lock(); owner != nullptr)
+                        owner->forget(entry);
+                    delete entry;
+                }
+            };
+
+            std::array<task_shard, shard_count> task_shards;
+            std::shared_ptr<name_index> names = std::make_shared<name_index>();
+
+        private:
+            task_shard& shard_of(task_id id) noexcept { return task_shards[static_cast<std::uint64_t>(id) % shard_count]; }
+            name_shard& shard_of(std::string_view name) noexcept { return names->shard_of(name); }
+
+        public:
+            task_registry() = default;
+            explicit task_registry(const Allocator& allocator)
+            {
+                for (auto& shard : task_shards)
+                    shard.tasks = task_map(typename task_map::allocator_type(allocator));
+            }
+
+        public:
+            // the entry for name, created when no live one exists. the caller owns it like every task of the name
+            std::shared_ptr<task_name> intern(std::string_view name)
+            {
+                if (auto entry = find_name(name); entry != nullptr)
+                    return entry;
+                std::shared_ptr<task_name> created(new task_name, name_release{ names });
+                created->text = name;
+                auto& shard = shard_of(name);
+                std::unique_lock lock(shard.mutex);
+                if (auto it = shard.names.find(name); it != shard.names.end())
+                {
+                    if (auto entry = it->second.weak.lock(); entry != nullptr)
+                        return entry;
+                    // its last owner is on the way to forget it, the key still views the dying entry's text
+                    shard.names.erase(it);
+                }
+                shard.names.emplace(created->text, indexed_name{ created.get(), created, nullptr });
+                return created;
+            }
+            std::shared_ptr<task_name> find_name(std::string_view name)
+            {
+                auto& shard = shard_of(name);
+                std::shared_lock lock(shard.mutex);
+                auto it = shard.names.find(name);
+                return it == shard.names.end() ? nullptr : it->second.weak.lock();
+            }
+            // pins a name whose options or totals must survive its tasks, generated names are never pinned and go
+            // with their last task
+            void keep(task_name& entry)
+            {
+                auto& shard = shard_of(entry.text);
+                std::unique_lock lock(shard.mutex);
+                if (auto it = shard.names.find(entry.text); it != shard.names.end() && it->second.entry == &entry && it->second.kept == nullptr)
+                    it->second.kept = it->second.weak.lock();
+            }
+
+        public:
+            // task->name_entry must already point at an interned name
+            void insert(std::shared_ptr<Task> task)
+            {
+                auto& name = *task->name_entry;
+                {
+                    std::lock_guard lock(name.members_mutex);
+                    task->name_prev = nullptr;
+                    task->name_next = name.members;
+                    if (name.members != nullptr)
+                        name.members->name_prev = task.get();
+                    name.members = task.get();
+                }
+                name.live.fetch_add(1, std::memory_order_release);
+
+                auto& shard = shard_of(task->id);
+                std::unique_lock lock(shard.mutex);
+                shard.tasks.emplace(task->id, std::move(task));
+            }
+            std::shared_ptr<Task> erase(task_id id)
+            {
+                std::shared_ptr<Task> task;
+                {
+                    auto& shard = shard_of(id);
+                    std::unique_lock lock(shard.mutex);
+                    auto it = shard.tasks.find(id);
+                    if (it == shard.tasks.end())
+                        return nullptr;
+                    task = std::move(it->second);
+                    shard.tasks.erase(it);
+                }
+
+                auto& name = *task->name_entry;
+                {
+                    std::lock_guard lock(name.members_mutex);
+                    if (task->name_prev != nullptr)
+                        task->name_prev->name_next = task->name_next;
+                    else
+                        name.members = task->name_next;
+                    if (task->name_next != nullptr)
+                        task->name_next->name_prev = task->name_prev;
+                }
+                name.live.fetch_sub(1, std::memory_order_release);
+                return task;
+            }
+
+        public:
+            std::shared_ptr<Task> find(task_id id)
+            {
+                auto& shard = shard_of(id);
+                std::shared_lock lock(shard.mutex);
+                auto it = shard.tasks.find(id);
+                return it == shard.tasks.end() ? nullptr : it->second;
+            }
+            bool contains(task_id id)
+            {
+                auto& shard = shard_of(id);
+                std::shared_lock lock(shard.mutex);
+                return shard.tasks.contains(id);
+            }
+            std::size_t count(std::string_view name)
+            {
+                auto entry = find_name(name);
+                return entry == nullptr ? 0 : entry->live.load(std::memory_order_acquire);
+            }
+            // both walks copy one shard's entries under its shared lock and call fn outside of it,
+            // so a slow fn never holds up inserts and erases
+            template <typename Fn> void for_each_task(Fn&& fn)
+            {
+                std::vector<std::shared_ptr<Task>> batch;
+                for (auto& shard : task_shards)
+                {
+                    {
+                        std::shared_lock lock(shard.mutex);
+                        for (auto& [_, task] : shard.tasks)
+                            batch.push_back(task);
+                    }
+                    for (auto& task : batch)
+                        fn(*task);
+                    batch.clear();
+                }
+            }
+            template <typename Fn> void for_each_name(Fn&& fn)
+            {
+                std::vector<std::shared_ptr<task_name>> batch;
+                for (auto& shard : names->shards)
+                {
+                    {
+                        std::shared_lock lock(shard.mutex);
+                        for (auto& [_, indexed] : shard.names)
+                            if (auto entry = indexed.weak.lock(); entry != nullptr)
+                                batch.push_back(std::move(entry));
+                    }
+                    for (auto& entry : batch)
+                        fn(*entry);
+                    batch.clear();
+                }
+            }
+            // the members' ids are copied under members_mutex and fn runs on the tasks still registered after it is
+            // released, so fn may start tasks, cancel them or configure the name
+            template <typename Fn> void for_each(std::string_view name, Fn&& fn)
+            {
+                auto entry = find_name(name);
+                if (entry == nullptr)
+                    return;
+                std::vector<task_id> ids;
+                {
+                    std::lock_guard lock(entry->members_mutex);
+                    for (auto hook = entry->members; hook != nullptr; hook = hook->name_next)
+                        ids.push_back(static_cast<Task&>(*hook).id);
+                }
+                for (auto id : ids)
+                    if (auto task = find(id); task != nullptr)
+                        fn(*task);
+            }
+        };
+    } // namespace detail
+} // namespace stdex
@@ -0,0 +1,99 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <latency_histogram.hpp>
+#include <slab_arena.hpp>
+#include <task_registry.hpp>
+
+namespace stdex
+{
+    struct run_stats
+    {
+        std::uint64_t runs = 0;
+        std::uint64_t overruns = 0; // periodic runs that finished after their next tick was due
+        std::chrono::nanoseconds total = {};
+        std::chrono::nanoseconds max = {};
+        std::chrono::steady_clock::time_point last_started = {}; // epoch until the first run
+        std::chrono::steady_clock::time_point last_finished = {};
+    };
+
+    struct task_stats
+    {
+        task_id id = task_id::invalid;
+        std::string name;
+        std::chrono::steady_clock::time_point created = {};
+        run_stats runs;
+        std::optional<jitter_stats> lateness; // start_wait / start_forever* tasks only
+    };
+
+    // totals over every task that ever ran under the name, finished ones included
+    struct name_stats
+    {
+        std::string name;
+        std::size_t live = 0;
+        run_stats runs;
+        jitter_stats lateness;
+    };
+
+    struct pool_stats
+    {
+        std::vector<task_stats> tasks;
+        std::vector<name_stats> names;
+        arena_stats memory; // the pool's task allocations, filled whether or not stats are collected
+    };
+
+    namespace detail
+    {
+        // relaxed counters, a snapshot taken while runs complete may mix two neighbouring runs
+        class run_counters
+        {
+            using clock = std::chrono::steady_clock;
+
+            std::atomic<std::uint64_t> runs = { 0 };
+            std::atomic<std::uint64_t> overruns = { 0 };
+            std::atomic<std::uint64_t> total_ns = { 0 };
+            std::atomic<std::uint64_t> max_ns = { 0 };
+            std::atomic<clock::rep> last_started = { 0 };
+            std::atomic<clock::rep> last_finished = { 0 };
+
+        public:
+            void record(clock::time_point begin, clock::time_point end, bool overrun) noexcept
+            {
+                auto ns = static_cast<std::uint64_t>(std::max<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count(), 0));
+                runs.fetch_add(1, std::memory_order_relaxed);
+                total_ns.fetch_add(ns, std::memory_order_relaxed);
+                if (overrun)
+                    overruns.fetch_add(1, std::memory_order_relaxed);
+                auto seen = max_ns.load(std::memory_order_relaxed);
+                while (ns > seen && !max_ns.compare_exchange_weak(seen, ns, std::memory_order_relaxed))
+                    ;
+                last_started.store(begin.time_since_epoch().count(), std::memory_order_relaxed);
+                last_finished.store(end.time_since_epoch().count(), std::memory_order_relaxed);
+            }
+
+            run_stats snapshot() const noexcept
+            {
+                return { runs.load(std::memory_order_relaxed),
+                         overruns.load(std::memory_order_relaxed),
+                         std::chrono::nanoseconds(total_ns.load(std::memory_order_relaxed)),
+                         std::chrono::nanoseconds(max_ns.load(std::memory_order_relaxed)),
+                         clock::time_point(clock::duration(last_started.load(std::memory_order_relaxed))),
+                         clock::time_point(clock::duration(last_finished.load(std::memory_order_relaxed))) };
+            }
+        };
+
+        // per name totals, hung off the interned name so they outlive the tasks
+        struct name_counters
+        {
+            run_counters runs;
+            latency_histogram lateness;
+        };
+    } // namespace detail
+} // namespace stdex
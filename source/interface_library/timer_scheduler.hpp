@@ -0,0 +1,106 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <work_stealing_executor.hpp>
+
+namespace stdex
+{
+    // what a periodic task does with ticks that passed while it was still running
+    enum class missed_tick_policy
+    {
+        catch_up, // run every missed tick back to back
+        skip,     // drop missed ticks and wait for the next one on the original phase
+        coalesce, // run once for all missed ticks and restart the phase from now
+    };
+
+    namespace detail
+    {
+        // one thread and a min-heap of deadlines for every delayed and periodic task of a pool.
+        // fire callbacks run on the timer thread and are expected to only hand work to an executor.
+        class timer_scheduler
+        {
+        public:
+            using clock = std::chrono::steady_clock;
+
+        private:
+            struct timer_entry
+            {
+                clock::time_point deadline;
+                std::uint64_t sequence;
+                task_function fire;
+            };
+            struct later
+            {
+                bool operator()(const timer_entry& a, const timer_entry& b) const noexcept
+                {
+                    return a.deadline != b.deadline ? a.deadline > b.deadline : a.sequence > b.sequence;
+                }
+            };
+
+            std::vector<timer_entry> heap;
+            std::uint64_t next_sequence = 0;
+            std::mutex mutex;
+            std::condition_variable_any cv;
+            std::jthread thread;
+
+        private:
+            void run(std::stop_token st)
+            {
+                std::unique_lock lock(mutex);
+                while (!st.stop_requested())
+                {
+                    if (heap.empty())
+                    {
+                        cv.wait(lock, st, [this] { return !heap.empty(); });
+                        continue;
+                    }
+
+                    auto deadline = heap.front().deadline;
+                    if (deadline > clock::now())
+                    {
+                        cv.wait_until(lock, st, deadline, [this, deadline] { return heap.front().deadline < deadline; });
+                        continue;
+                    }
+
+                    std::pop_heap(heap.begin(), heap.end(), later{});
+                    auto fire = std::move(heap.back().fire);
+                    heap.pop_back();
+                    lock.unlock();
+                    fire();
+                    lock.lock();
+                }
+            }
+
+        public:
+            timer_scheduler() : thread([this](std::stop_token st) { this->run(st); }) {}
+            ~timer_scheduler()
+            {
+                thread.request_stop();
+                thread.join();
+            }
+            timer_scheduler(const timer_scheduler&) = delete;
+            timer_scheduler& operator=(const timer_scheduler&) = delete;
+
+        public:
+            void schedule_at(clock::time_point deadline, task_function fire)
+            {
+                {
+                    std::lock_guard lock(mutex);
+                    heap.push_back({ deadline, next_sequence++, std::move(fire) });
+                    std::push_heap(heap.begin(), heap.end(), later{});
+                    if (heap.front().sequence != next_sequence - 1)
+                        return;
+                }
+                cv.notify_one();
+            }
+        };
+    } // namespace detail
+} // namespace stdex
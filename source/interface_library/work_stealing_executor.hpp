@@ -0,0 +1,374 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cpu_topology.hpp>
+
+namespace stdex
+{
+    // strict within one worker's queue: high drains before normal before low. a worker still prefers its own
+    // queue, so a low job can run while another worker has a high one queued
+    enum class task_priority : std::uint8_t
+    {
+        high,
+        normal,
+        low,
+    };
+    inline constexpr std::size_t task_priority_count = 3;
+
+    namespace detail
+    {
+        // move-only type erased void() callable, std::function requires copyable targets. closures up to
+        // inline_size bytes are stored in place, bigger ones are allocated with the allocator they were given
+        class task_function
+        {
+        public:
+            static constexpr std::size_t inline_size = 48;
+
+        private:
+            struct operations
+            {
+                void (*invoke)(void* storage);
+                void (*relocate)(void* from, void* to) noexcept; // move constructs into to and destroys from
+                void (*destroy)(void* storage) noexcept;
+            };
+            template <typename Fn> static constexpr bool stored_inline = sizeof(Fn) <= inline_size && alignof(Fn) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<Fn>;
+
+            template <typename Fn> static constexpr operations inline_operations = {
+                [](void* storage) { (*static_cast<Fn*>(storage))(); },
+                [](void* from, void* to) noexcept {
+                    ::new (to) Fn(std::move(*static_cast<Fn*>(from)));
+                    static_cast<Fn*>(from)->~Fn();
+                },
+                [](void* storage) noexcept { static_cast<Fn*>(storage)->~Fn(); },
+            };
+            template <typename Fn, typename Allocator> struct boxed
+            {
+                using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<boxed>;
+                allocator_type allocator;
+                Fn fn;
+
+                static boxed*& pointer(void* storage) noexcept { return *static_cast<boxed**>(storage); }
+                static constexpr operations boxed_operations = {
+                    [](void* storage) { pointer(storage)->fn(); },
+                    [](void* from, void* to) noexcept { ::new (to) boxed*(pointer(from)); },
+                    [](void* storage) noexcept {
+                        auto self = pointer(storage);
+                        allocator_type allocator = std::move(self->allocator);
+                        self->~boxed();
+                        std::allocator_traits<allocator_type>::deallocate(allocator, self, 1);
+                    },
+                };
+            };
+
+            alignas(std::max_align_t) std::byte storage[inline_size];
+            const operations* ops = nullptr;
+
+        private:
+            template <typename Allocator, typename Fn> void construct(const Allocator& allocator, Fn&& fn)
+            {
+                using target = std::decay_t<Fn>;
+                if constexpr (stored_inline<target>)
+                {
+                    ::new (static_cast<void*>(storage)) target(std::forward<Fn>(fn));
+                    ops = &inline_operations<target>;
+                }
+                else
+                {
+                    using box = boxed<target, Allocator>;
+                    typename box::allocator_type box_allocator(allocator);
+                    auto self = std::allocator_traits<typename box::allocator_type>::allocate(box_allocator, 1);
+                    try
+                    {
+                        ::new (static_cast<void*>(self)) box{ box_allocator, std::forward<Fn>(fn) };
+                    }
+                    catch (...)
+                    {
+                        std::allocator_traits<typename box::allocator_type>::deallocate(box_allocator, self, 1);
+                        throw;
+                    }
+                    ::new (static_cast<void*>(storage)) box*(self);
+                    ops = &box::boxed_operations;
+                }
+            }
+            void reset() noexcept
+            {
+                if (ops != nullptr)
+                    std::exchange(ops, nullptr)->destroy(storage);
+            }
+
+        public:
+            task_function() = default;
+            template <typename Fn, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Fn>, task_function>>> task_function(Fn&& fn)
+            {
+                construct(std::allocator<std::byte>(), std::forward<Fn>(fn));
+            }
+            template <typename Allocator, typename Fn> task_function(std::allocator_arg_t, const Allocator& allocator, Fn&& fn)
+            {
+                construct(allocator, std::forward<Fn>(fn));
+            }
+            task_function(task_function&& other) noexcept
+            {
+                if (other.ops != nullptr)
+                {
+                    other.ops->relocate(other.storage, storage);
+                    ops = std::exchange(other.ops, nullptr);
+                }
+            }
+            task_function& operator=(task_function&& other) noexcept
+            {
+                if (this != &other)
+                {
+                    reset();
+                    if (other.ops != nullptr)
+                    {
+                        other.ops->relocate(other.storage, storage);
+                        ops = std::exchange(other.ops, nullptr);
+                    }
+                }
+                return *this;
+            }
+            ~task_function() { reset(); }
+
+            explicit operator bool() const noexcept { return ops != nullptr; }
+            void operator()() { ops->invoke(storage); }
+        };
+
+        // who may run a job submitted to one worker's queue
+        enum class job_scope : std::uint8_t
+        {
+            any,    // every worker may steal it
+            group,  // only the workers of the same group, e.g. the same NUMA node
+            worker, // only that worker
+        };
+        inline constexpr std::size_t job_scope_count = 3;
+
+        struct job_target
+        {
+            std::size_t worker = 0;
+            job_scope scope = job_scope::any; // any ignores worker and spreads round robin
+        };
+
+        // where one worker runs: cpus it is restricted to (empty leaves it to the OS) and the group it shares
+        // group jobs with. node and cpu only describe the placement for callers that pick targets
+        struct worker_layout
+        {
+            std::vector<int> cpus;
+            std::size_t group = 0;
+            int node = -1; // -1 when the worker is not bound to a node
+            int cpu = -1;  // -1 when the worker is not pinned to a single cpu
+        };
+
+        // fixed set of workers, each owning a deque per priority and scope: jobs are pushed at the back and taken from
+        // the front, so periodic jobs that keep resubmitting cannot starve older ones of their class. idle workers steal
+        // the jobs they are allowed to run from the others, external submissions are spread round robin.
+        class work_stealing_executor
+        {
+            struct alignas(64) worker_queue
+            {
+                std::mutex mutex;
+                std::array<std::array<std::deque<task_function>, job_scope_count>, task_priority_count> jobs;
+
+                // under mutex. priorities stay strict, within one the narrowest scope goes first as nobody else may take it
+                bool take(task_function& job, job_scope widest)
+                {
+                    for (auto& level : jobs)
+                        for (auto scope = static_cast<std::size_t>(widest) + 1; scope-- > 0;)
+                            if (auto& jobs_of_scope = level[scope]; !jobs_of_scope.empty())
+                            {
+                                job = std::move(jobs_of_scope.front());
+                                jobs_of_scope.pop_front();
+                                return true;
+                            }
+                    return false;
+                }
+            };
+            struct worker_context
+            {
+                const work_stealing_executor* owner;
+                std::size_t index;
+            };
+            static inline thread_local worker_context current = { nullptr, 0 };
+
+            std::vector<std::unique_ptr<worker_queue>> queues;
+            std::vector<worker_layout> layouts;
+            std::atomic<std::size_t> next_queue = { 0 };
+            std::atomic<std::uint32_t> work_epoch = { 0 };
+            std::atomic<std::uint32_t> sleepers = { 0 };
+            std::stop_source stop_source;
+            std::vector<std::jthread> workers;
+
+        private:
+            // the widest scope thief may take from victim's queue, external threads only get unbound jobs
+            job_scope reach(std::size_t thief, std::size_t victim, bool worker) const noexcept
+            {
+                if (!worker)
+                    return job_scope::any;
+                if (thief == victim)
+                    return job_scope::worker;
+                return layouts[thief].group == layouts[victim].group ? job_scope::group : job_scope::any;
+            }
+            bool try_pop(std::size_t index, task_function& job, job_scope widest = job_scope::worker)
+            {
+                auto& queue = *queues[index];
+                std::lock_guard lock(queue.mutex);
+                return queue.take(job, widest);
+            }
+            bool try_steal(std::size_t thief, task_function& job, bool worker = true)
+            {
+                for (std::size_t offset = 1; offset < queues.size(); offset++)
+                {
+                    auto victim = (thief + offset) % queues.size();
+                    auto& queue = *queues[victim];
+                    std::unique_lock lock(queue.mutex, std::try_to_lock);
+                    if (lock.owns_lock() && queue.take(job, reach(thief, victim, worker)))
+                        return true;
+                }
+                return false;
+            }
+            bool try_acquire(std::size_t index, task_function& job)
+            {
+                if (try_pop(index, job) || try_steal(index, job))
+                    return true;
+                // try_steal skips contended queues, take one blocking pass before parking
+                for (std::size_t offset = 1; offset < queues.size(); offset++)
+                {
+                    auto victim = (index + offset) % queues.size();
+                    auto& queue = *queues[victim];
+                    std::lock_guard lock(queue.mutex);
+                    if (queue.take(job, reach(index, victim, true)))
+                        return true;
+                }
+                return false;
+            }
+
+            // the pool's own jobs catch everything they run, a throwing job from outside is dropped here so
+            // the worker, and the process, survive it
+            static void run(task_function& job) noexcept
+            {
+                try
+                {
+                    job();
+                }
+                catch (...)
+                {
+                }
+                job = {};
+            }
+
+            void work(std::stop_token st, std::size_t index)
+            {
+                pin_current_thread(layouts[index].cpus);
+                current = { this, index };
+                task_function job;
+                while (true)
+                {
+                    auto epoch = work_epoch.load();
+                    if (try_acquire(index, job))
+                    {
+                        run(job);
+                        continue;
+                    }
+                    if (st.stop_requested())
+                        break;
+                    sleepers.fetch_add(1);
+                    work_epoch.wait(epoch);
+                    sleepers.fetch_sub(1);
+                }
+                current = { nullptr, 0 };
+            }
+
+            // a bound job wakes every sleeper, the one woken by notify_one might not be allowed to take it
+            void wake(bool bound = false)
+            {
+                work_epoch.fetch_add(1);
+                if (sleepers.load() == 0)
+                    return;
+                if (bound)
+                    work_epoch.notify_all();
+                else
+                    work_epoch.notify_one();
+            }
+
+        public:
+            explicit work_stealing_executor(std::size_t worker_count = std::thread::hardware_concurrency())
+                : work_stealing_executor(std::vector<worker_layout>(std::max<std::size_t>(worker_count, 1)))
+            {
+            }
+            explicit work_stealing_executor(std::vector<worker_layout> layout) : layouts(std::move(layout))
+            {
+                if (layouts.empty())
+                    layouts.resize(1);
+                for (std::size_t i = 0; i < layouts.size(); i++)
+                    queues.push_back(std::make_unique<worker_queue>());
+                for (std::size_t i = 0; i < layouts.size(); i++)
+                    workers.emplace_back([this, i] { this->work(stop_source.get_token(), i); });
+            }
+            ~work_stealing_executor()
+            {
+                // queued jobs are drained before the workers leave
+                stop_source.request_stop();
+                work_epoch.fetch_add(1);
+                work_epoch.notify_all();
+                workers.clear();
+            }
+            work_stealing_executor(const work_stealing_executor&) = delete;
+            work_stealing_executor& operator=(const work_stealing_executor&) = delete;
+
+        public:
+            std::size_t size() const noexcept { return workers.size(); }
+            const worker_layout& layout(std::size_t worker) const noexcept { return layouts[worker]; }
+            bool in_worker() const noexcept { return current.owner == this; }
+
+            // runs one queued job on the calling thread, for threads that would otherwise block on jobs they submitted
+            bool try_run_one()
+            {
+                task_function job;
+                auto worker = in_worker();
+                auto index = worker ? current.index : next_queue.load(std::memory_order_relaxed) % queues.size();
+                if (!try_pop(index, job, worker ? job_scope::worker : job_scope::any) && !try_steal(index, job, worker))
+                    return false;
+                run(job);
+                return true;
+            }
+
+            // only the queue push allocates, when it throws job is left as it was
+            void submit(task_function&& job, task_priority priority = task_priority::normal)
+            {
+                auto index = in_worker() ? current.index : next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+                {
+                    auto& queue = *queues[index];
+                    std::lock_guard lock(queue.mutex);
+                    queue.jobs[static_cast<std::size_t>(priority)][static_cast<std::size_t>(job_scope::any)].push_back(std::move(job));
+                }
+                wake();
+            }
+            void submit(task_function&& job, task_priority priority, job_target target)
+            {
+                if (target.scope == job_scope::any)
+                {
+                    submit(std::move(job), priority);
+                    return;
+                }
+                {
+                    auto& queue = *queues[target.worker % queues.size()];
+                    std::lock_guard lock(queue.mutex);
+                    queue.jobs[static_cast<std::size_t>(priority)][static_cast<std::size_t>(target.scope)].push_back(std::move(job));
+                }
+                wake(true);
+            }
+        };
+    } // namespace detail
+} // namespace stdex
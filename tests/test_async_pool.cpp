@@ -0,0 +1,395 @@
+#include <gtest/gtest.h>
+#include <self_releasing_async.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+TEST(async_pool, start_runs_the_task_and_wait_returns_after_it)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 2);
+    std::atomic<int> ran = { 0 };
+    auto id = pool.start("work", [&](int add) { ran += add; }, 3);
+    ASSERT_NE(id, stdex::task_id::invalid);
+    pool.wait(id);
+    EXPECT_EQ(ran.load(), 3);
+}
+
+TEST(async_pool, names_and_id_describe_live_tasks)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 2);
+    std::atomic<bool> release = { false };
+    std::vector<stdex::task_id> ids;
+    for (int i = 0; i < 3; i++)
+        ids.push_back(pool.start("group", [&] {
+            while (!release)
+                std::this_thread::sleep_for(1ms);
+        }));
+    EXPECT_TRUE(pool.has("group"));
+    EXPECT_EQ(pool.count("group"), 3u);
+    EXPECT_FALSE(pool.has("other"));
+
+    auto tasks = pool.names("group");
+    ASSERT_EQ(tasks.size(), 3u);
+    // the public name is an owning string, it can be kept and combined like before
+    std::string label = tasks[0].name + "#0";
+    EXPECT_EQ(label, "group#0");
+
+    auto task = pool.id(ids[1]);
+    ASSERT_NE(task, nullptr);
+    EXPECT_EQ(task->id, ids[1]);
+    EXPECT_EQ(task->name, "group");
+
+    release = true;
+    pool.wait_all("group");
+    for (auto& entry : tasks)
+        entry.future.wait();
+}
+
+TEST(async_pool, both_launch_modes_run_tasks)
+{
+    for (auto mode : { stdex::launch_mode::worker_pool, stdex::launch_mode::thread_per_task })
+    {
+        stdex::detail::async_pool pool(mode, 2);
+        std::atomic<int> ran = { 0 };
+        std::vector<stdex::task_id> ids;
+        for (int i = 0; i < 20; i++)
+            ids.push_back(pool.start("each", [&] { ran++; }));
+        for (auto id : ids)
+            pool.wait(id);
+        EXPECT_EQ(ran.load(), 20);
+    }
+}
+
+TEST(async_pool, the_default_pool_serves_the_free_functions)
+{
+    std::atomic<bool> release = { false };
+    auto id = stdex::start("default pool task", [&] {
+        while (!release)
+            std::this_thread::sleep_for(1ms);
+    });
+    EXPECT_TRUE(stdex::has("default pool task"));
+    EXPECT_TRUE(stdex::has(id));
+    release = true;
+    stdex::detail::default_pool.wait(id);
+}
+
+TEST(async_pool, a_throwing_posted_job_does_not_take_the_worker_down)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 1);
+    std::atomic<int> ran = { 0 };
+    for (int i = 0; i < 10; i++)
+        pool.post([&, i] {
+            ran++;
+            if (i % 2 == 0)
+                throw std::runtime_error("posted job failed");
+        });
+    std::atomic<bool> after = { false };
+    pool.wait(pool.start("after", [&] { after = true; }));
+    while (ran != 10)
+        std::this_thread::yield();
+    EXPECT_TRUE(after.load());
+}
+
+TEST(async_pool, a_limited_name_never_runs_more_than_its_limit)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 4);
+    pool.configure("limited", { .max_in_flight = 2 });
+    std::atomic<int> running = { 0 };
+    std::atomic<int> peak = { 0 };
+    std::vector<stdex::task_id> ids;
+    for (int i = 0; i < 16; i++)
+        ids.push_back(pool.start("limited", [&] {
+            auto now = ++running;
+            for (auto seen = peak.load(); seen < now && !peak.compare_exchange_weak(seen, now);)
+                ;
+            std::this_thread::sleep_for(1ms);
+            running--;
+        }));
+    for (auto id : ids)
+    {
+        ASSERT_NE(id, stdex::task_id::invalid);
+        pool.wait(id);
+    }
+    EXPECT_LE(peak.load(), 2);
+    EXPECT_GE(peak.load(), 1);
+}
+
+TEST(async_pool, a_full_rejecting_name_turns_tasks_away_and_raising_the_limit_admits_waiting_ones)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 4);
+    std::atomic<bool> release = { false };
+    auto blocked = [&] {
+        while (!release)
+            std::this_thread::sleep_for(1ms);
+    };
+
+    pool.configure("rejecting", { .max_in_flight = 1, .when_full = stdex::limit_policy::reject });
+    auto first = pool.start("rejecting", blocked);
+    EXPECT_NE(first, stdex::task_id::invalid);
+    EXPECT_EQ(pool.start("rejecting", blocked), stdex::task_id::invalid);
+    EXPECT_EQ(pool.count("rejecting"), 1u);
+
+    pool.configure("queued", { .max_in_flight = 1 });
+    std::atomic<int> started = { 0 };
+    std::vector<stdex::task_id> ids;
+    for (int i = 0; i < 3; i++)
+        ids.push_back(pool.start("queued", [&] {
+            started++;
+            blocked();
+        }));
+    while (started == 0)
+        std::this_thread::sleep_for(1ms);
+    EXPECT_EQ(pool.count("queued"), 3u);
+    pool.configure("queued", { .max_in_flight = 3 });
+    while (started != 3)
+        std::this_thread::sleep_for(1ms);
+
+    release = true;
+    pool.wait(first);
+    for (auto id : ids)
+        pool.wait(id);
+    EXPECT_EQ(started.load(), 3);
+}
+
+TEST(async_pool, finished_tasks_are_reaped_without_a_sweep)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 2);
+    std::vector<stdex::task_id> ids;
+    for (int i = 0; i < 2000; i++)
+        ids.push_back(pool.start("reaped", [] {}));
+    for (auto id : ids)
+        pool.wait(id);
+    auto until = std::chrono::steady_clock::now() + 5s;
+    while (pool.count("reaped") != 0 && std::chrono::steady_clock::now() < until)
+        std::this_thread::sleep_for(1ms);
+    EXPECT_EQ(pool.count("reaped"), 0u);
+    for (auto id : ids)
+        ASSERT_FALSE(pool.has(id));
+}
+
+TEST(async_pool, a_finished_task_leaves_well_before_the_old_sweep_interval)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 2);
+    // the first completions also warm the runner up, only the best of a few rounds is checked
+    auto best = std::chrono::steady_clock::duration::max();
+    for (int round = 0; round < 5; round++)
+    {
+        auto id = pool.start("quick", [] {});
+        pool.wait(id);
+        auto finished = std::chrono::steady_clock::now();
+        while (pool.has(id))
+            std::this_thread::yield();
+        best = std::min(best, std::chrono::steady_clock::now() - finished);
+    }
+    EXPECT_LT(best, 50ms);
+}
+
+TEST(async_pool, start_wait_runs_once_its_delay_passed)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 2);
+    auto started = std::chrono::steady_clock::now();
+    std::atomic<std::chrono::steady_clock::rep> ran_at = { 0 };
+    auto id = pool.start_wait("delayed", 30ms, [&] { ran_at = std::chrono::steady_clock::now().time_since_epoch().count(); });
+    EXPECT_TRUE(pool.has(id));
+    pool.wait(id);
+    auto ran = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(ran_at.load()));
+    EXPECT_GE(ran - started, 30ms);
+}
+
+TEST(async_pool, periodic_tasks_share_the_timer_and_stop_on_request)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 2);
+    constexpr int periodic = 200;
+    std::vector<std::atomic<int>> ticks(periodic);
+    std::vector<stdex::task_id> ids;
+    for (int i = 0; i < periodic; i++)
+        ids.push_back(pool.start_forever("periodic", 2ms, [&ticks, i] { ticks[i]++; }));
+    auto until = std::chrono::steady_clock::now() + 10s;
+    auto all_ticked = [&] { return std::all_of(ticks.begin(), ticks.end(), [](const std::atomic<int>& count) { return count.load() >= 3; }); };
+    while (!all_ticked() && std::chrono::steady_clock::now() < until)
+        std::this_thread::sleep_for(1ms);
+    EXPECT_TRUE(all_ticked());
+    auto jitter = pool.jitter(ids[0]);
+    ASSERT_TRUE(jitter.has_value());
+    EXPECT_GE(jitter->ticks, 3u);
+
+    for (auto id : ids)
+        pool.stop_forever(id);
+    for (auto id : ids)
+        pool.wait(id);
+    std::vector<int> stopped;
+    for (auto& count : ticks)
+        stopped.push_back(count.load());
+    std::this_thread::sleep_for(10ms);
+    for (int i = 0; i < periodic; i++)
+        ASSERT_EQ(ticks[i].load(), stopped[i]);
+}
+
+TEST(async_pool, missed_ticks_follow_the_policy)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 2);
+    // every run overruns its tick, catch_up runs the missed ones back to back while skip keeps the phase
+    auto count_runs = [&](stdex::missed_tick_policy policy) {
+        std::atomic<int> runs = { 0 };
+        auto id = pool.start_forever("slow", 5ms, policy, [&] {
+            runs++;
+            std::this_thread::sleep_for(12ms);
+        });
+        std::this_thread::sleep_for(150ms);
+        pool.stop_forever(id);
+        pool.wait(id);
+        return runs.load();
+    };
+    auto skipped = count_runs(stdex::missed_tick_policy::skip);
+    auto caught_up = count_runs(stdex::missed_tick_policy::catch_up);
+    EXPECT_GT(skipped, 0);
+    EXPECT_GE(caught_up, skipped);
+}
+
+TEST(async_pool, stats_count_runs_per_task_and_per_name)
+{
+    stdex::async_pool_options options;
+    options.worker_count = 2;
+    options.collect_stats = true;
+    stdex::detail::async_pool pool(options);
+    for (int i = 0; i < 10; i++)
+        pool.wait(pool.start("counted", [] { std::this_thread::sleep_for(1ms); }));
+
+    std::atomic<bool> release = { false };
+    auto live = pool.start("live", [&] {
+        while (!release)
+            std::this_thread::sleep_for(1ms);
+    });
+    auto slow = pool.start_forever("overrunning", 2ms, [] { std::this_thread::sleep_for(5ms); });
+    std::this_thread::sleep_for(50ms);
+
+    auto stats = pool.stats();
+    auto name = std::find_if(stats.names.begin(), stats.names.end(), [](const stdex::name_stats& entry) { return entry.name == "counted"; });
+    ASSERT_NE(name, stats.names.end());
+    EXPECT_EQ(name->runs.runs, 10u);
+    EXPECT_GE(name->runs.total, 10ms);
+    EXPECT_GE(name->runs.max, 1ms);
+    EXPECT_LE(name->runs.max, name->runs.total);
+    EXPECT_GE(name->runs.last_finished, name->runs.last_started);
+
+    auto task = std::find_if(stats.tasks.begin(), stats.tasks.end(), [&](const stdex::task_stats& entry) { return entry.id == live; });
+    ASSERT_NE(task, stats.tasks.end());
+    EXPECT_EQ(task->name, "live");
+    EXPECT_FALSE(task->lateness.has_value());
+
+    auto periodic = std::find_if(stats.tasks.begin(), stats.tasks.end(), [&](const stdex::task_stats& entry) { return entry.id == slow; });
+    ASSERT_NE(periodic, stats.tasks.end());
+    EXPECT_GT(periodic->runs.runs, 0u);
+    EXPECT_GT(periodic->runs.overruns, 0u);
+    ASSERT_TRUE(periodic->lateness.has_value());
+
+    release = true;
+    pool.stop_forever(slow);
+    pool.wait(slow);
+    pool.wait(live);
+}
+
+TEST(async_pool, stats_stay_empty_until_collection_is_enabled)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 2);
+    pool.wait(pool.start("before", [] {}));
+    pool.enable_stats(true);
+    pool.wait(pool.start("after", [] {}));
+    auto stats = pool.stats();
+    auto find = [&](std::string_view name) { return std::find_if(stats.names.begin(), stats.names.end(), [&](const stdex::name_stats& entry) { return entry.name == name; }); };
+    // listed only until its task is reaped, and without totals either way
+    if (auto before = find("before"); before != stats.names.end())
+        EXPECT_EQ(before->runs.runs, 0u);
+    ASSERT_NE(find("after"), stats.names.end());
+    EXPECT_EQ(find("after")->runs.runs, 1u);
+}
+
+TEST(async_pool, a_stop_callback_may_start_a_task_of_the_cancelled_name)
+{
+    stdex::detail::async_pool pool;
+    std::atomic<bool> running = { false };
+    std::atomic<int> restarted = { 0 };
+    auto id = pool.start("service", [&](std::stop_token st) {
+        std::stop_callback restart(st, [&] {
+            pool.start("service", [] {});
+            restarted++;
+        });
+        running = true;
+        while (!st.stop_requested())
+            std::this_thread::sleep_for(1ms);
+    });
+    while (!running)
+        std::this_thread::yield();
+    EXPECT_EQ(pool.cancel("service"), 1u);
+    pool.wait(id);
+    EXPECT_EQ(restarted.load(), 1);
+    pool.wait_all("service");
+}
+
+TEST(async_pool, cancel_fails_a_task_that_has_not_started)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 2);
+    std::atomic<bool> ran = { false };
+    auto id = pool.start_wait("later", 10s, [&] { ran = true; });
+    auto task = pool.id(id);
+    ASSERT_NE(task, nullptr);
+    EXPECT_TRUE(pool.cancel(id));
+    EXPECT_THROW(task->future.get(), stdex::task_cancelled);
+    EXPECT_FALSE(ran.load());
+    EXPECT_FALSE(pool.cancel(stdex::task_id::invalid));
+}
+
+TEST(async_pool, running_tasks_see_cancel_and_deadlines_through_their_stop_token)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 4);
+    auto until_stopped = [](std::stop_token st) {
+        while (!st.stop_requested())
+            std::this_thread::sleep_for(1ms);
+    };
+    std::vector<stdex::task_id> named;
+    for (int i = 0; i < 2; i++)
+        named.push_back(pool.start("group", until_stopped));
+    auto timed = pool.start_for("timed", 20ms, until_stopped);
+    auto later = pool.start("later", until_stopped);
+    EXPECT_TRUE(pool.set_deadline(later, std::chrono::steady_clock::now() + 20ms));
+
+    EXPECT_EQ(pool.cancel("group"), 2u);
+    for (auto id : named)
+        pool.wait(id);
+    pool.wait(timed);
+    pool.wait(later);
+    while (pool.has(later))
+        std::this_thread::sleep_for(1ms);
+    EXPECT_FALSE(pool.set_deadline(later, std::chrono::steady_clock::now()));
+}
+
+TEST(async_pool, shutdown_stops_running_tasks_and_fails_waiting_ones)
+{
+    std::shared_ptr<const stdex::detail::async_task> waiting;
+    std::atomic<bool> running = { false };
+    auto begin = std::chrono::steady_clock::now();
+    {
+        stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 2);
+        pool.start("endless", [&](std::stop_token st) {
+            running = true;
+            while (!st.stop_requested())
+                std::this_thread::sleep_for(1ms);
+        });
+        waiting = pool.id(pool.start_wait("never", 10s, [] {}));
+        ASSERT_NE(waiting, nullptr);
+        while (!running)
+            std::this_thread::yield();
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - begin, 5s);
+    EXPECT_THROW(waiting->future.get(), stdex::task_cancelled);
+}
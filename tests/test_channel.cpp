@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include <channel.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct counted
+    {
+        static inline std::atomic<int> live = { 0 };
+        std::uint64_t value = 0;
+
+        counted() { live++; }
+        explicit counted(std::uint64_t value) : value(value) { live++; }
+        counted(const counted& other) : value(other.value) { live++; }
+        counted& operator=(const counted&) = default;
+        ~counted() { live--; }
+    };
+
+    // producers send disjoint ranges through a small ring so both ends keep wrapping and waiting, every id
+    // must come out exactly once
+    template <typename Channel> void check_exactly_once(Channel& channel, std::size_t producers, std::size_t consumers)
+    {
+        constexpr std::uint64_t per_producer = 20000;
+        std::vector<std::atomic<std::uint32_t>> received(producers * per_producer);
+        {
+            std::vector<std::jthread> receivers;
+            for (std::size_t c = 0; c < consumers; c++)
+                receivers.emplace_back([&] {
+                    std::uint64_t value = 0;
+                    while (channel.recv(value) == stdex::channel_status::ok)
+                        received[value].fetch_add(1, std::memory_order_relaxed);
+                });
+            {
+                std::vector<std::jthread> senders;
+                for (std::size_t p = 0; p < producers; p++)
+                    senders.emplace_back([&, p] {
+                        for (std::uint64_t i = 0; i < per_producer; i++)
+                            EXPECT_EQ(channel.send(p * per_producer + i), stdex::channel_status::ok);
+                    });
+            }
+            channel.close();
+        }
+        std::size_t wrong = 0;
+        for (auto& count : received)
+            wrong += count.load() != 1;
+        EXPECT_EQ(wrong, 0u);
+    }
+} // namespace
+
+TEST(bounded_channel, spsc_delivers_every_item_once)
+{
+    stdex::bounded_channel<std::uint64_t, stdex::channel_kind::spsc> channel(64);
+    check_exactly_once(channel, 1, 1);
+}
+
+TEST(bounded_channel, mpsc_delivers_every_item_once)
+{
+    stdex::bounded_channel<std::uint64_t, stdex::channel_kind::mpsc> channel(64);
+    check_exactly_once(channel, 4, 1);
+}
+
+TEST(bounded_channel, mpmc_delivers_every_item_once)
+{
+    stdex::bounded_channel<std::uint64_t, stdex::channel_kind::mpmc> channel(64);
+    check_exactly_once(channel, 4, 4);
+}
+
+TEST(unbounded_channel, delivers_every_item_once)
+{
+    stdex::unbounded_channel<std::uint64_t> channel;
+    check_exactly_once(channel, 4, 2);
+}
+
+TEST(bounded_channel, keeps_fifo_order_for_one_sender)
+{
+    stdex::bounded_channel<std::uint64_t, stdex::channel_kind::spsc> channel(8);
+    std::jthread sender([&] {
+        for (std::uint64_t i = 0; i < 10000; i++)
+            channel.send(i);
+        channel.close();
+    });
+    std::uint64_t expected = 0;
+    std::uint64_t value = 0;
+    while (channel.recv(value) == stdex::channel_status::ok)
+        ASSERT_EQ(value, expected++);
+    EXPECT_EQ(expected, 10000u);
+}
+
+TEST(bounded_channel, reports_full_empty_and_closed)
+{
+    stdex::bounded_channel<int> channel(2);
+    int value = 0;
+    EXPECT_EQ(channel.try_recv(value), stdex::channel_status::empty);
+    EXPECT_EQ(channel.try_send(1), stdex::channel_status::ok);
+    EXPECT_EQ(channel.try_send(2), stdex::channel_status::ok);
+    EXPECT_EQ(channel.try_send(3), stdex::channel_status::full);
+    channel.close();
+    EXPECT_EQ(channel.try_send(4), stdex::channel_status::closed);
+    EXPECT_EQ(channel.recv(value), stdex::channel_status::ok);
+    EXPECT_EQ(value, 1);
+    EXPECT_EQ(channel.recv(value), stdex::channel_status::ok);
+    EXPECT_EQ(value, 2);
+    EXPECT_EQ(channel.recv(value), stdex::channel_status::closed);
+}
+
+TEST(bounded_channel, destroys_items_left_in_the_ring)
+{
+    {
+        stdex::bounded_channel<counted, stdex::channel_kind::spsc> lamport(16);
+        stdex::bounded_channel<counted, stdex::channel_kind::mpmc> vyukov(16);
+        for (std::uint64_t i = 0; i < 40; i++)
+        {
+            lamport.try_send(counted(i));
+            vyukov.try_send(counted(i));
+            counted out;
+            if (i % 3 == 0)
+            {
+                lamport.try_recv(out);
+                vyukov.try_recv(out);
+            }
+        }
+    }
+    EXPECT_EQ(counted::live.load(), 0);
+}
+
+TEST(bounded_channel, send_n_moves_move_only_items_through)
+{
+    stdex::bounded_channel<std::unique_ptr<int>, stdex::channel_kind::spsc> channel(8);
+    std::vector<std::unique_ptr<int>> items;
+    for (int i = 0; i < 100; i++)
+        items.push_back(std::make_unique<int>(i));
+    std::jthread sender([&] {
+        EXPECT_EQ(channel.send_n(std::make_move_iterator(items.begin()), items.size()), items.size());
+        channel.close();
+    });
+    std::vector<std::unique_ptr<int>> received;
+    while (channel.recv_n(std::back_inserter(received), 16) != 0)
+        ;
+    sender.join();
+    ASSERT_EQ(received.size(), 100u);
+    for (int i = 0; i < 100; i++)
+    {
+        ASSERT_NE(received[i], nullptr);
+        EXPECT_EQ(*received[i], i);
+        EXPECT_EQ(items[i], nullptr);
+    }
+}
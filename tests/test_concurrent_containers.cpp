@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include <concurrent_unordered_map.hpp>
+#include <concurrent_vector.hpp>
+#include <epoch_reclamation.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct counted
+    {
+        static inline std::atomic<int> live = { 0 };
+        std::uint64_t value = 0;
+
+        explicit counted(std::uint64_t value) : value(value)
+        {
+            if (value == throwing_value)
+                throw std::runtime_error("refused");
+            live++;
+        }
+        counted(const counted& other) : value(other.value) { live++; }
+        ~counted() { live--; }
+
+        static constexpr std::uint64_t throwing_value = ~std::uint64_t(0);
+    };
+
+    // nodes replaced or erased go through the epoch domain, retiring filler runs its collections
+    void drain_epochs()
+    {
+        for (int i = 0; i < 10000 && counted::live.load() != 0; i++)
+        {
+            stdex::detail::epoch_guard guard;
+            stdex::detail::epoch_domain::instance().retire(new int(i));
+        }
+    }
+} // namespace
+
+TEST(concurrent_unordered_map, readers_never_miss_a_key_while_it_grows)
+{
+    constexpr std::uint64_t present = 512;
+    constexpr std::uint64_t added = 50000;
+    stdex::concurrent_unordered_map<std::uint64_t, std::uint64_t> map;
+    for (std::uint64_t key = 0; key < present; key++)
+        map.insert(key, key * 3);
+    std::atomic<bool> done = { false };
+    std::atomic<std::uint64_t> misses = { 0 };
+    std::atomic<std::uint64_t> wrong = { 0 };
+    {
+        std::vector<std::jthread> readers;
+        for (int r = 0; r < 3; r++)
+            readers.emplace_back([&, r] {
+                for (std::uint64_t key = static_cast<std::uint64_t>(r); !done; key = (key + 7) % present)
+                {
+                    auto value = map.get(key);
+                    if (!value)
+                        misses++;
+                    else if (*value != key * 3)
+                        wrong++;
+                }
+            });
+        for (std::uint64_t key = present; key < present + added; key++)
+            map.insert(key, key * 3);
+        done = true;
+    }
+    EXPECT_EQ(misses.load(), 0u);
+    EXPECT_EQ(wrong.load(), 0u);
+    EXPECT_EQ(map.size(), present + added);
+    for (std::uint64_t key = 0; key < present + added; key += 97)
+        EXPECT_EQ(map.get(key), key * 3);
+}
+
+TEST(concurrent_unordered_map, concurrent_writers_keep_one_entry_per_key)
+{
+    constexpr std::uint64_t keys = 4096;
+    stdex::concurrent_unordered_map<std::uint64_t, std::uint64_t> map;
+    std::atomic<std::uint64_t> inserted = { 0 };
+    {
+        std::vector<std::jthread> writers;
+        for (int w = 0; w < 4; w++)
+            writers.emplace_back([&] {
+                for (std::uint64_t key = 0; key < keys; key++)
+                {
+                    inserted += map.insert(key, key);
+                    map.update(key, [](const std::uint64_t* current) { return current == nullptr ? 1 : *current + 1; });
+                }
+            });
+    }
+    EXPECT_EQ(inserted.load(), keys);
+    EXPECT_EQ(map.size(), keys);
+    std::uint64_t entries = 0;
+    map.for_each([&](const std::uint64_t& key, const std::uint64_t& value) {
+        entries++;
+        EXPECT_EQ(value, key + 4);
+    });
+    EXPECT_EQ(entries, keys);
+}
+
+TEST(concurrent_unordered_map, frees_every_node_it_replaced_or_erased)
+{
+    {
+        stdex::concurrent_unordered_map<std::uint64_t, counted> map;
+        for (std::uint64_t key = 0; key < 1000; key++)
+            map.try_emplace(key, key);
+        for (std::uint64_t key = 0; key < 1000; key += 2)
+            map.insert_or_assign(key, counted(key + 1));
+        for (std::uint64_t key = 0; key < 1000; key += 3)
+            map.erase(key);
+        map.clear();
+        for (std::uint64_t key = 0; key < 100; key++)
+            map.try_emplace(key, key);
+    }
+    drain_epochs();
+    EXPECT_EQ(counted::live.load(), 0);
+}
+
+TEST(concurrent_vector, concurrent_push_backs_keep_every_element)
+{
+    constexpr std::uint64_t per_thread = 20000;
+    stdex::concurrent_vector<std::uint64_t> vector;
+    {
+        std::vector<std::jthread> pushers;
+        for (std::uint64_t t = 0; t < 4; t++)
+            pushers.emplace_back([&, t] {
+                for (std::uint64_t i = 0; i < per_thread; i++)
+                    vector.push_back(t * per_thread + i);
+            });
+    }
+    ASSERT_EQ(vector.size(), 4 * per_thread);
+    std::vector<int> seen(4 * per_thread, 0);
+    vector.for_each([&](std::uint64_t value) { seen[value]++; });
+    for (auto count : seen)
+        ASSERT_EQ(count, 1);
+}
+
+TEST(concurrent_vector, a_throwing_constructor_leaves_an_empty_slot)
+{
+    {
+        stdex::concurrent_vector<counted> vector;
+        vector.emplace_back(1u);
+        EXPECT_THROW(vector.emplace_back(counted::throwing_value), std::runtime_error);
+        vector.emplace_back(3u);
+        EXPECT_EQ(vector.size(), 3u);
+        EXPECT_TRUE(vector.constructed(0));
+        EXPECT_FALSE(vector.constructed(1));
+        EXPECT_THROW(vector.at(1), std::out_of_range);
+        EXPECT_EQ(vector.at(2).value, 3u);
+        std::uint64_t sum = 0;
+        vector.for_each([&](const counted& item) { sum += item.value; });
+        EXPECT_EQ(sum, 4u);
+        EXPECT_EQ(counted::live.load(), 2);
+    }
+    EXPECT_EQ(counted::live.load(), 0);
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include <channel.hpp>
+#include <coroutine.hpp>
+#include <syncer.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    stdex::task<int> add_on_worker(stdex::detail::async_pool& pool, int a, int b)
+    {
+        co_await pool.schedule();
+        co_return a + b;
+    }
+    stdex::task<int> add_twice(stdex::detail::async_pool& pool, int a, int b)
+    {
+        auto first = co_await add_on_worker(pool, a, b);
+        co_await pool.delay(1ms);
+        co_return first + co_await add_on_worker(pool, a, b);
+    }
+    stdex::task<void> fail_on_worker(stdex::detail::async_pool& pool)
+    {
+        co_await pool.schedule();
+        throw std::runtime_error("coroutine failed");
+    }
+
+    // starts right away and leaves its frame to the test, so the frame can be destroyed while it is suspended
+    struct owned_coroutine
+    {
+        struct promise_type
+        {
+            std::atomic<bool> finished = { false }; // set once the frame is suspended at its end
+
+            struct final_awaiter
+            {
+                bool await_ready() const noexcept { return false; }
+                void await_suspend(std::coroutine_handle<promise_type> frame) const noexcept { frame.promise().finished.store(true, std::memory_order_release); }
+                void await_resume() const noexcept {}
+            };
+
+            owned_coroutine get_return_object() noexcept { return { std::coroutine_handle<promise_type>::from_promise(*this) }; }
+            std::suspend_never initial_suspend() const noexcept { return {}; }
+            final_awaiter final_suspend() const noexcept { return {}; }
+            void return_void() const noexcept {}
+            void unhandled_exception() const noexcept { std::terminate(); }
+        };
+        std::coroutine_handle<promise_type> handle;
+
+        bool finished() const noexcept { return handle.promise().finished.load(std::memory_order_acquire); }
+    };
+    owned_coroutine receive_one(stdex::bounded_channel<int>& channel, stdex::detail::async_pool& pool, std::atomic<int>& received)
+    {
+        int value = 0;
+        if (co_await channel.recv_async(value, pool) == stdex::channel_status::ok)
+            received += value;
+    }
+} // namespace
+
+TEST(coroutine, sync_wait_returns_the_result_of_a_task_chain)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 2);
+    EXPECT_EQ(stdex::sync_wait(add_twice(pool, 2, 3)), 10);
+}
+
+TEST(coroutine, sync_wait_rethrows_what_the_task_threw)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 2);
+    EXPECT_THROW(stdex::sync_wait(fail_on_worker(pool)), std::runtime_error);
+}
+
+TEST(coroutine, spawned_tasks_run_on_the_pool)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 2);
+    std::atomic<int> sum = { 0 };
+    auto caller = std::this_thread::get_id();
+    std::atomic<int> on_caller = { 0 };
+    for (int i = 1; i <= 10; i++)
+        stdex::spawn(pool, [](stdex::detail::async_pool& pool, std::atomic<int>& sum, std::atomic<int>& on_caller, std::thread::id caller, int i) -> stdex::task<void> {
+            on_caller += std::this_thread::get_id() == caller;
+            sum += co_await add_on_worker(pool, i, 0);
+        }(pool, sum, on_caller, caller, i));
+    auto until = std::chrono::steady_clock::now() + 10s;
+    while (sum != 55 && std::chrono::steady_clock::now() < until)
+        std::this_thread::sleep_for(1ms);
+    EXPECT_EQ(sum.load(), 55);
+    EXPECT_EQ(on_caller.load(), 0);
+}
+
+TEST(coroutine, channel_awaits_hand_items_between_coroutines)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 2);
+    stdex::bounded_channel<int> channel(4);
+    auto consumer = [](stdex::bounded_channel<int>& channel, stdex::detail::async_pool& pool) -> stdex::task<std::int64_t> {
+        std::int64_t sum = 0;
+        int value = 0;
+        while (co_await channel.recv_async(value, pool) == stdex::channel_status::ok)
+            sum += value;
+        co_return sum;
+    };
+    std::jthread producer([&] {
+        for (int i = 1; i <= 1000; i++)
+            channel.send(i);
+        channel.close();
+    });
+    EXPECT_EQ(stdex::sync_wait(consumer(channel, pool)), 500500);
+}
+
+TEST(coroutine, a_destroyed_waiter_is_not_resumed)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 2);
+    stdex::bounded_channel<int> channel(4);
+    std::atomic<int> received = { 0 };
+    std::vector<owned_coroutine> waiting;
+    for (int i = 0; i < 8; i++)
+        waiting.push_back(receive_one(channel, pool, received));
+    for (auto& coroutine : waiting)
+        ASSERT_FALSE(coroutine.finished());
+    // half go while suspended on the channel, the others must still get their items
+    for (std::size_t i = 0; i < waiting.size(); i += 2)
+        waiting[i].handle.destroy();
+    for (int i = 0; i < 4; i++)
+        channel.send(1);
+    auto until = std::chrono::steady_clock::now() + 10s;
+    while (received != 4 && std::chrono::steady_clock::now() < until)
+        std::this_thread::sleep_for(1ms);
+    EXPECT_EQ(received.load(), 4);
+    channel.close();
+    for (std::size_t i = 1; i < waiting.size(); i += 2)
+    {
+        while (!waiting[i].finished())
+            std::this_thread::sleep_for(1ms);
+        waiting[i].handle.destroy();
+    }
+}
+
+TEST(coroutine, a_waiter_destroyed_after_its_wake_was_posted_is_left_alone)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 1);
+    std::atomic<bool> release = { false };
+    // keeps the only worker busy, so the wake below is posted but cannot run yet
+    pool.post([&] {
+        while (!release)
+            std::this_thread::sleep_for(1ms);
+    });
+    stdex::bounded_channel<int> channel(4);
+    std::atomic<int> received = { 0 };
+    auto coroutine = receive_one(channel, pool, received);
+    channel.send(1);
+    coroutine.handle.destroy();
+    release = true;
+    // the posted wake finds its awaiter gone, the item stays in the channel
+    pool.wait(pool.start("after", [] {}));
+    int value = 0;
+    EXPECT_EQ(channel.try_recv(value), stdex::channel_status::ok);
+    EXPECT_EQ(received.load(), 0);
+}
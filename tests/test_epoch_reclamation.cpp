@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <epoch_reclamation.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct tracked
+    {
+        static inline std::atomic<int> live = { 0 };
+        static inline std::atomic<bool> protected_by_guard = { false };
+        static inline std::atomic<int> freed_too_early = { 0 };
+        bool retired_under_guard = false;
+
+        tracked() { live++; }
+        ~tracked()
+        {
+            if (retired_under_guard && protected_by_guard)
+                freed_too_early++;
+            live--;
+        }
+    };
+
+    // retires filler until everything older has gone, collection runs every few dozen retires
+    void retire_until_freed(int baseline)
+    {
+        for (int i = 0; i < 100000 && tracked::live.load() > baseline; i++)
+        {
+            stdex::detail::epoch_guard guard;
+            stdex::detail::epoch_domain::instance().retire(new tracked);
+        }
+    }
+} // namespace
+
+TEST(epoch_reclamation, an_open_guard_holds_back_what_was_retired_after_it)
+{
+    std::atomic<bool> entered = { false };
+    std::atomic<bool> release = { false };
+    std::jthread reader([&] {
+        stdex::detail::epoch_guard guard;
+        tracked::protected_by_guard = true;
+        entered = true;
+        while (!release)
+            std::this_thread::yield();
+        tracked::protected_by_guard = false;
+    });
+    while (!entered)
+        std::this_thread::yield();
+
+    auto& domain = stdex::detail::epoch_domain::instance();
+    for (int i = 0; i < 1000; i++)
+    {
+        auto item = new tracked;
+        item->retired_under_guard = true;
+        domain.retire(item);
+    }
+    EXPECT_EQ(tracked::freed_too_early.load(), 0);
+    EXPECT_GE(tracked::live.load(), 1000);
+
+    release = true;
+    reader.join();
+    retire_until_freed(200);
+    EXPECT_EQ(tracked::freed_too_early.load(), 0);
+    EXPECT_LE(tracked::live.load(), 200);
+}
+
+TEST(epoch_reclamation, garbage_of_exited_threads_is_reclaimed)
+{
+    auto before = tracked::live.load();
+    {
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < 4; t++)
+            threads.emplace_back([] {
+                for (int i = 0; i < 1000; i++)
+                {
+                    stdex::detail::epoch_guard guard;
+                    stdex::detail::epoch_domain::instance().retire(new tracked);
+                }
+            });
+    }
+    // what the threads left unfreed moved to the orphans, the next collections free it
+    retire_until_freed(before + 200);
+    EXPECT_LE(tracked::live.load(), before + 200);
+}
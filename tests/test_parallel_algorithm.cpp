@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <parallel_algorithm.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(parallel_algorithm, parallel_for_visits_every_index_once)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 4);
+    std::vector<std::atomic<int>> visits(100000);
+    stdex::parallel_for(pool, std::size_t(0), visits.size(), [&](std::size_t i) { visits[i]++; }, 1000);
+    EXPECT_TRUE(std::all_of(visits.begin(), visits.end(), [](const std::atomic<int>& count) { return count.load() == 1; }));
+}
+
+TEST(parallel_algorithm, reduce_transform_and_sort_match_the_sequential_ones)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 4);
+    std::vector<std::uint64_t> values(200000);
+    std::mt19937_64 random(7);
+    for (auto& value : values)
+        value = random() % 1000000;
+
+    EXPECT_EQ(stdex::parallel_reduce(pool, values, std::uint64_t(5), std::plus<>{}, 1000), std::accumulate(values.begin(), values.end(), std::uint64_t(5)));
+
+    std::vector<std::uint64_t> doubled(values.size());
+    stdex::parallel_transform(pool, values, doubled.begin(), [](std::uint64_t value) { return value * 2; }, 1000);
+    for (std::size_t i = 0; i < values.size(); i += 101)
+        ASSERT_EQ(doubled[i], values[i] * 2);
+
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+    stdex::parallel_sort(pool, values, std::less<>{}, 1000);
+    EXPECT_EQ(values, expected);
+}
+
+TEST(parallel_algorithm, the_first_exception_reaches_the_caller)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 4);
+    std::atomic<int> ran = { 0 };
+    EXPECT_THROW(stdex::parallel_for(
+                     pool, 0, 1000,
+                     [&](int i) {
+                         ran++;
+                         if (i == 500)
+                             throw std::runtime_error("chunk failed");
+                     },
+                     10),
+                 std::runtime_error);
+    EXPECT_GT(ran.load(), 0);
+}
+
+TEST(parallel_algorithm, the_caller_only_runs_its_own_chunks)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 2);
+    auto caller = std::this_thread::get_id();
+    std::atomic<int> foreign_on_caller = { 0 };
+    std::atomic<int> foreign_done = { 0 };
+    for (int i = 0; i < 64; i++)
+        pool.post([&] {
+            if (std::this_thread::get_id() == caller)
+                foreign_on_caller++;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            foreign_done++;
+        });
+    std::atomic<int> sum = { 0 };
+    stdex::parallel_for(pool, 0, 10000, [&](int i) { sum += i % 3; }, 10);
+    EXPECT_EQ(sum.load(), 9999);
+    EXPECT_EQ(foreign_on_caller.load(), 0);
+    while (foreign_done != 64)
+        std::this_thread::yield();
+}
+
+TEST(parallel_algorithm, sort_merges_wide_rounds_in_pieces_and_takes_move_only_values)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 4);
+    std::mt19937_64 random(11);
+    for (std::size_t count : { 4097u, 50000u, 100003u })
+    {
+        std::vector<std::uint64_t> values(count);
+        for (auto& value : values)
+            value = random() % 100; // many equal keys across the cuts
+        auto expected = values;
+        std::sort(expected.begin(), expected.end());
+        stdex::parallel_sort(pool, values, std::less<>{}, 4096);
+        ASSERT_EQ(values, expected);
+    }
+
+    std::vector<std::unique_ptr<int>> boxes;
+    for (int i = 0; i < 30000; i++)
+        boxes.push_back(std::make_unique<int>(static_cast<int>(random() % 1000)));
+    stdex::parallel_sort(pool, boxes, [](const auto& a, const auto& b) { return *a < *b; }, 1000);
+    EXPECT_TRUE(std::is_sorted(boxes.begin(), boxes.end(), [](const auto& a, const auto& b) { return *a < *b; }));
+    EXPECT_TRUE(std::none_of(boxes.begin(), boxes.end(), [](const auto& box) { return box == nullptr; }));
+}
+
+TEST(parallel_algorithm, nested_calls_from_every_worker_finish)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 2);
+    std::atomic<std::uint64_t> sum = { 0 };
+    stdex::parallel_for(pool, 0, 8, [&](int outer) {
+        stdex::parallel_for(pool, 0, 1000, [&](int inner) { sum += static_cast<std::uint64_t>(outer * 1000 + inner); }, 10);
+    }, 1);
+    EXPECT_EQ(sum.load(), 8000u * 7999u / 2);
+}
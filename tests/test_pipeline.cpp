@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <pipeline.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(pipeline, every_item_passes_each_stage_once)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 4);
+    constexpr std::uint64_t count = 20000;
+    std::vector<std::atomic<int>> arrived(count);
+    {
+        auto p = stdex::pipeline_builder<std::uint64_t>(pool)
+                     .stage("double", [](std::uint64_t value) { return value * 2; }, { .parallelism = 3, .capacity = 64, .batch = 8 })
+                     .stage("halve", [](std::uint64_t value) { return value / 2; }, { .parallelism = 2, .capacity = 16 })
+                     .sink("count", [&](std::uint64_t value) { arrived[value]++; }, { .parallelism = 2 });
+        for (std::uint64_t i = 0; i < count; i++)
+            ASSERT_TRUE(p.push(i));
+        p.close();
+        p.wait();
+        auto stats = p.stats();
+        ASSERT_EQ(stats.stages.size(), 3u);
+        for (auto& stage : stats.stages)
+        {
+            EXPECT_EQ(stage.accepted, count);
+            EXPECT_EQ(stage.processed, count);
+            EXPECT_EQ(stage.dropped, 0u);
+            EXPECT_EQ(stage.queue_depth, 0u);
+        }
+    }
+    for (auto& times : arrived)
+        ASSERT_EQ(times.load(), 1);
+}
+
+TEST(pipeline, filters_and_failures_are_counted_not_forwarded)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 2);
+    std::atomic<std::uint64_t> sum = { 0 };
+    auto p = stdex::pipeline_builder<int>(pool)
+                 .stage("odd only", [](int value) -> std::optional<int> { return value % 2 != 0 ? std::optional<int>(value) : std::nullopt; })
+                 .stage("no sevens",
+                        [](int value) {
+                            if (value % 7 == 0)
+                                throw std::runtime_error("seven");
+                            return value;
+                        })
+                 .sink("sum", [&](int value) { sum += static_cast<std::uint64_t>(value); });
+    std::uint64_t expected = 0;
+    std::uint64_t sevens = 0;
+    for (int i = 0; i < 1000; i++)
+    {
+        p.push(i);
+        if (i % 2 != 0 && i % 7 != 0)
+            expected += static_cast<std::uint64_t>(i);
+        sevens += i % 2 != 0 && i % 7 == 0;
+    }
+    p.close();
+    p.wait();
+    EXPECT_EQ(sum.load(), expected);
+    auto stats = p.stats();
+    EXPECT_EQ(stats.stages[1].accepted, 500u);
+    EXPECT_EQ(stats.stages[1].failed, sevens);
+}
+
+TEST(pipeline, the_drop_policy_turns_items_away_instead_of_blocking)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 2);
+    std::atomic<bool> release = { false };
+    std::atomic<std::uint64_t> seen = { 0 };
+    auto p = stdex::pipeline_builder<int>(pool).sink(
+        "slow",
+        [&](int) {
+            while (!release)
+                std::this_thread::yield();
+            seen++;
+        },
+        { .capacity = 4, .batch = 1, .when_full = stdex::backpressure_policy::drop });
+    std::uint64_t accepted = 0;
+    for (int i = 0; i < 100; i++)
+        accepted += p.try_push(i);
+    release = true;
+    p.close();
+    p.wait();
+    auto stats = p.stats();
+    EXPECT_LT(accepted, 100u);
+    EXPECT_EQ(stats.stages[0].accepted, accepted);
+    EXPECT_EQ(stats.stages[0].dropped, 100u - accepted);
+    EXPECT_EQ(seen.load(), accepted);
+}
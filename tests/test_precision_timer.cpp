@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include <self_releasing_async.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+TEST(precision_timer, entries_fire_in_deadline_order_and_never_early)
+{
+    for (auto backend : { stdex::precision_backend::nanosleep, stdex::precision_backend::timerfd })
+    {
+        stdex::detail::precision_timer timer({ .backend = backend });
+        using clock = stdex::detail::precision_timer::clock;
+        std::mutex mutex;
+        std::vector<int> order;
+        std::atomic<int> early = { 0 };
+        std::atomic<int> fired = { 0 };
+        auto now = clock::now();
+        for (int i : { 3, 1, 4, 0, 2 })
+        {
+            auto deadline = now + std::chrono::milliseconds(5 + i * 3);
+            timer.schedule_at(deadline, [&, i, deadline] {
+                early += clock::now() < deadline;
+                std::lock_guard lock(mutex);
+                order.push_back(i);
+                fired++;
+            });
+        }
+        while (fired != 5)
+            std::this_thread::sleep_for(1ms);
+        EXPECT_EQ(early.load(), 0);
+        EXPECT_EQ(order, (std::vector<int>{ 0, 1, 2, 3, 4 }));
+    }
+}
+
+TEST(precision_timer, precise_ticks_keep_coming_while_every_worker_is_busy)
+{
+    stdex::detail::async_pool pool(stdex::launch_mode::worker_pool, 2);
+    std::atomic<bool> release = { false };
+    std::atomic<int> blocking = { 0 };
+    for (int i = 0; i < 2; i++)
+        pool.post([&] {
+            blocking++;
+            while (!release)
+                std::this_thread::sleep_for(1ms);
+        });
+    while (blocking != 2)
+        std::this_thread::sleep_for(1ms);
+
+    std::atomic<int> ticks = { 0 };
+    auto id = pool.start_forever_high_resolution("precise", 2ms, [&] { ticks++; });
+    auto until = std::chrono::steady_clock::now() + 5s;
+    while (ticks < 5 && std::chrono::steady_clock::now() < until)
+        std::this_thread::sleep_for(1ms);
+    EXPECT_GE(ticks.load(), 5);
+
+    release = true;
+    pool.cancel(id);
+    pool.wait(id);
+}
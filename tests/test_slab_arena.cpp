@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <slab_arena.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using stdex::detail::slab_arena;
+
+TEST(slab_arena, blocks_freed_on_other_threads_are_reused)
+{
+    auto arena = slab_arena::create();
+    constexpr std::size_t count = 20000;
+    std::vector<void*> blocks(count);
+    for (auto& block : blocks)
+    {
+        block = slab_arena::allocate(arena.get(), 48, alignof(std::max_align_t));
+        std::memset(block, 0xab, 48);
+    }
+    auto filled = arena->stats();
+    EXPECT_EQ(filled.blocks_in_use, count);
+
+    // every free is remote: four threads give back disjoint quarters
+    {
+        std::vector<std::jthread> freeing;
+        for (std::size_t t = 0; t < 4; t++)
+            freeing.emplace_back([&, t] {
+                for (auto i = t; i < count; i += 4)
+                    slab_arena::deallocate(arena.get(), blocks[i], 48, alignof(std::max_align_t));
+            });
+    }
+    EXPECT_EQ(arena->stats().blocks_in_use, 0u);
+
+    for (auto& block : blocks)
+        block = slab_arena::allocate(arena.get(), 48, alignof(std::max_align_t));
+    auto refilled = arena->stats();
+    EXPECT_EQ(refilled.blocks_in_use, count);
+    EXPECT_EQ(refilled.slabs, filled.slabs);
+    for (auto block : blocks)
+        slab_arena::deallocate(arena.get(), block, 48, alignof(std::max_align_t));
+}
+
+TEST(slab_arena, concurrent_allocate_and_remote_free_hand_out_distinct_blocks)
+{
+    auto arena = slab_arena::create();
+    constexpr std::size_t rounds = 20000;
+    std::atomic<void*> handoff[4] = {};
+    std::atomic<std::size_t> overlaps = { 0 };
+    {
+        std::vector<std::jthread> threads;
+        // each producer writes its id into fresh blocks, a consumer checks the mark and frees the block
+        for (std::size_t t = 0; t < 4; t++)
+            threads.emplace_back([&, t] {
+                for (std::size_t i = 0; i < rounds; i++)
+                {
+                    auto block = static_cast<std::size_t*>(slab_arena::allocate(arena.get(), 64, alignof(std::size_t)));
+                    block[0] = t;
+                    block[1] = i;
+                    void* expected = nullptr;
+                    while (!handoff[t].compare_exchange_weak(expected, block))
+                    {
+                        expected = nullptr;
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        for (std::size_t t = 0; t < 4; t++)
+            threads.emplace_back([&, t] {
+                for (std::size_t i = 0; i < rounds; i++)
+                {
+                    void* taken = nullptr;
+                    while ((taken = handoff[t].exchange(nullptr)) == nullptr)
+                        std::this_thread::yield();
+                    auto block = static_cast<std::size_t*>(taken);
+                    if (block[0] != t || block[1] != i)
+                        overlaps++;
+                    slab_arena::deallocate(arena.get(), block, 64, alignof(std::size_t));
+                }
+            });
+    }
+    EXPECT_EQ(overlaps.load(), 0u);
+    EXPECT_EQ(arena->stats().blocks_in_use, 0u);
+}
+
+TEST(slab_arena, blocks_may_outlive_the_arena)
+{
+    std::vector<void*> blocks;
+    slab_arena* closed = nullptr;
+    {
+        auto arena = slab_arena::create();
+        closed = arena.get();
+        for (int i = 0; i < 100; i++)
+            blocks.push_back(slab_arena::allocate(arena.get(), 200, alignof(std::max_align_t)));
+        // the arena is closed here, the slabs stay until their last block comes back
+    }
+    for (auto block : blocks)
+        std::memset(block, 0, 200);
+    // deallocate only tells the arena apart from operator new, it never dereferences a closed one
+    std::jthread remote([&] {
+        for (auto block : blocks)
+            slab_arena::deallocate(closed, block, 200, alignof(std::max_align_t));
+    });
+}
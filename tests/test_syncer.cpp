@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+#include <syncer.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // every word carries the same number, a reader that sees two different ones saw a torn write
+    struct stamp
+    {
+        std::array<std::uint64_t, 8> words = {};
+
+        stamp() = default;
+        explicit stamp(std::uint64_t value) { words.fill(value); }
+        std::uint64_t value() const noexcept { return words[0]; }
+        bool intact() const noexcept
+        {
+            for (auto word : words)
+                if (word != words[0])
+                    return false;
+            return true;
+        }
+    };
+
+    // counts live instances so a test can tell that everything was destroyed
+    struct counted
+    {
+        static inline std::atomic<int> live = { 0 };
+        std::uint64_t value = 0;
+
+        counted() { live++; }
+        explicit counted(std::uint64_t value) : value(value) { live++; }
+        counted(const counted& other) : value(other.value) { live++; }
+        counted& operator=(const counted&) = default;
+        ~counted() { live--; }
+    };
+
+    constexpr std::uint64_t publishes = 20000;
+} // namespace
+
+TEST(syncer, try_sync_reports_each_change_once)
+{
+    stdex::syncer<int> s;
+    int value = 0;
+    EXPECT_FALSE(s.try_sync(value));
+    s.set(3);
+    EXPECT_TRUE(s.try_sync(value));
+    EXPECT_EQ(value, 3);
+    EXPECT_FALSE(s.try_sync(value));
+    EXPECT_EQ(s.get(), 3);
+}
+
+TEST(syncer, try_take_moves_move_only_values_out)
+{
+    stdex::syncer<std::unique_ptr<int>> s;
+    std::unique_ptr<int> out;
+    EXPECT_FALSE(s.try_take(out));
+    s.set(std::make_unique<int>(5));
+    EXPECT_EQ(s.with([](const std::unique_ptr<int>& held) { return held ? *held : -1; }), 5);
+    ASSERT_TRUE(s.try_take(out));
+    ASSERT_NE(out, nullptr);
+    EXPECT_EQ(*out, 5);
+    EXPECT_FALSE(s.try_take(out));
+    EXPECT_EQ(*out, 5);
+}
+
+TEST(syncer, try_take_sees_an_increasing_sequence)
+{
+    stdex::syncer<std::unique_ptr<std::uint64_t>> s;
+    std::atomic<bool> done = { false };
+    std::jthread writer([&] {
+        for (std::uint64_t i = 1; i <= publishes; i++)
+            s.emplace(std::make_unique<std::uint64_t>(i));
+        done = true;
+    });
+    std::uint64_t last = 0;
+    while (!done || s.changed())
+    {
+        std::unique_ptr<std::uint64_t> taken;
+        if (!s.try_take(taken))
+            continue;
+        ASSERT_NE(taken, nullptr);
+        ASSERT_GT(*taken, last);
+        last = *taken;
+    }
+    EXPECT_EQ(last, publishes);
+}
+
+TEST(triple_buffer_syncer, one_consumer_sees_intact_increasing_values)
+{
+    stdex::triple_buffer_syncer<stamp> s;
+    std::atomic<bool> done = { false };
+    std::jthread writer([&] {
+        for (std::uint64_t i = 1; i <= publishes; i++)
+            s.set(stamp(i));
+        done = true;
+    });
+    std::uint64_t last = 0;
+    stamp value;
+    while (!done || s.changed())
+    {
+        if (!s.try_sync(value))
+            continue;
+        ASSERT_TRUE(value.intact());
+        ASSERT_GT(value.value(), last);
+        last = value.value();
+    }
+    EXPECT_EQ(last, publishes);
+    EXPECT_TRUE(s.view().intact());
+}
+
+TEST(triple_buffer_syncer, several_writers_never_tear)
+{
+    stdex::triple_buffer_syncer<stamp> s;
+    std::atomic<int> writing = { 4 };
+    {
+        std::vector<std::jthread> writers;
+        for (std::uint64_t w = 0; w < 4; w++)
+            writers.emplace_back([&, w] {
+                for (std::uint64_t i = 0; i < publishes / 4; i++)
+                    s.set(stamp(w << 32 | i));
+                writing--;
+            });
+        stamp value;
+        while (writing != 0)
+        {
+            if (s.try_sync(value))
+            {
+                ASSERT_TRUE(value.intact());
+            }
+        }
+    }
+    EXPECT_TRUE(s.get().intact());
+}
+
+TEST(syncer_lock_free, many_readers_never_tear)
+{
+    stdex::syncer<stamp, true> s;
+    s.set(stamp(0));
+    std::atomic<bool> done = { false };
+    std::atomic<std::uint64_t> torn = { 0 };
+    {
+        std::vector<std::jthread> readers;
+        for (int r = 0; r < 4; r++)
+            readers.emplace_back([&] {
+                std::uint64_t last = 0;
+                while (!done)
+                {
+                    auto value = s.get();
+                    if (!value.intact() || value.value() < last)
+                        torn++;
+                    last = value.value();
+                }
+            });
+        for (std::uint64_t i = 1; i <= publishes; i++)
+            s.set(stamp(i));
+        done = true;
+    }
+    EXPECT_EQ(torn.load(), 0u);
+    EXPECT_EQ(s.get().value(), publishes);
+}
+
+TEST(versioned_syncer, a_pinned_view_is_never_overwritten)
+{
+    stdex::versioned_syncer<stamp> s;
+    s.set(stamp(1));
+    auto pinned = s.get_view();
+    auto version = pinned.version();
+    std::jthread writer([&] {
+        for (std::uint64_t i = 2; i <= publishes; i++)
+            s.set(stamp(i));
+    });
+    writer.join();
+    EXPECT_EQ(pinned->value(), 1u);
+    EXPECT_TRUE(pinned->intact());
+    EXPECT_EQ(pinned.version(), version);
+    EXPECT_EQ(s.get().value(), publishes);
+    EXPECT_GT(s.version(), version);
+}
+
+TEST(versioned_syncer, readers_see_increasing_versions)
+{
+    stdex::versioned_syncer<stamp> s;
+    std::atomic<bool> done = { false };
+    std::atomic<std::uint64_t> failures = { 0 };
+    {
+        std::vector<std::jthread> readers;
+        for (int r = 0; r < 3; r++)
+            readers.emplace_back([&] {
+                auto reader = s.make_reader();
+                std::uint64_t last_version = 0;
+                std::uint64_t last_value = 0;
+                while (!done)
+                {
+                    auto view = reader.try_view();
+                    if (!view)
+                        continue;
+                    if (view->version() <= last_version || !(*view)->intact() || (*view)->value() < last_value)
+                        failures++;
+                    last_version = view->version();
+                    last_value = (*view)->value();
+                }
+            });
+        for (std::uint64_t i = 1; i <= publishes; i++)
+            s.set(stamp(i));
+        done = true;
+    }
+    EXPECT_EQ(failures.load(), 0u);
+}
+
+TEST(snapshot_syncer, snapshots_outlive_publishes_and_are_freed)
+{
+    {
+        stdex::snapshot_syncer<counted> s;
+        EXPECT_EQ(s.snapshot(), nullptr);
+        s.emplace(1u);
+        auto first = s.snapshot();
+        auto reader = s.make_reader();
+        for (std::uint64_t i = 2; i <= 100; i++)
+            s.emplace(i);
+        EXPECT_EQ(first->value, 1u);
+        auto latest = reader.try_snapshot();
+        ASSERT_NE(latest, nullptr);
+        EXPECT_EQ(latest->value, 100u);
+        EXPECT_EQ(reader.try_snapshot(), nullptr);
+        EXPECT_EQ(counted::live.load(), 2);
+    }
+    EXPECT_EQ(counted::live.load(), 0);
+}
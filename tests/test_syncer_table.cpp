@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <syncer_table.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(syncer_table, visits_each_changed_slot_once_and_clears_the_bitmap)
+{
+    stdex::syncer_table<int> table(10000);
+    EXPECT_FALSE(table.changed());
+    // both sides of a dirty word and of a summary word
+    const std::vector<std::size_t> touched = { 0, 63, 64, 4095, 4096, 9999 };
+    for (auto index : touched)
+        table.set(index, static_cast<int>(index) + 1);
+    table.set(64, 1000);
+    EXPECT_TRUE(table.changed());
+    EXPECT_TRUE(table.changed(4096));
+    EXPECT_FALSE(table.changed(1));
+
+    std::vector<std::size_t> visited;
+    auto count = table.for_each_changed([&](std::size_t index, const int& value) {
+        visited.push_back(index);
+        EXPECT_EQ(value, index == 64 ? 1000 : static_cast<int>(index) + 1);
+    });
+    EXPECT_EQ(count, touched.size());
+    EXPECT_EQ(visited, touched);
+    EXPECT_FALSE(table.changed());
+    EXPECT_EQ(table.for_each_changed([](std::size_t, const int&) { FAIL(); }), 0u);
+}
+
+TEST(syncer_table, a_throwing_callback_leaves_the_rest_marked)
+{
+    stdex::syncer_array<int, 256> table;
+    for (std::size_t index : { 1, 2, 3, 200 })
+        table.set(index, 7);
+    EXPECT_THROW(table.for_each_changed([](std::size_t index, const int&) {
+        if (index == 2)
+            throw std::runtime_error("stop");
+    }),
+                 std::runtime_error);
+    std::vector<std::size_t> rest;
+    table.for_each_changed([&](std::size_t index, const int&) { rest.push_back(index); });
+    EXPECT_EQ(rest, (std::vector<std::size_t>{ 3, 200 }));
+    EXPECT_FALSE(table.changed());
+}
+
+TEST(syncer_table, concurrent_writers_lose_no_final_value)
+{
+    constexpr std::size_t slots = 8192;
+    constexpr int rounds = 50;
+    constexpr std::size_t writer_count = 4;
+    stdex::syncer_table<int> table(slots);
+    std::vector<int> seen(slots, 0);
+    std::atomic<std::size_t> writing = { writer_count };
+    std::size_t regressions = 0;
+    {
+        std::vector<std::jthread> writers;
+        for (std::size_t w = 0; w < writer_count; w++)
+            writers.emplace_back([&, w] {
+                for (int round = 1; round <= rounds; round++)
+                    for (auto index = w; index < slots; index += writer_count)
+                        table.set(index, round);
+                writing--;
+            });
+        auto consume = [&] {
+            table.for_each_changed([&](std::size_t index, const int& value) {
+                regressions += value < seen[index];
+                seen[index] = value;
+            });
+        };
+        while (writing != 0)
+            consume();
+        consume();
+    }
+    EXPECT_EQ(regressions, 0u);
+    EXPECT_TRUE(std::all_of(seen.begin(), seen.end(), [](int value) { return value == rounds; }));
+    EXPECT_FALSE(table.changed());
+}
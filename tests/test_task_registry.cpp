@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include <self_releasing_async.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    std::size_t name_count(stdex::detail::task_registry<stdex::detail::task_control>& registry)
+    {
+        std::size_t count = 0;
+        registry.for_each_name([&](stdex::detail::task_name&) { count++; });
+        return count;
+    }
+} // namespace
+
+TEST(task_registry, names_go_with_their_last_owner)
+{
+    stdex::detail::task_registry<stdex::detail::task_control> registry;
+    for (int i = 0; i < 1000; i++)
+        registry.intern("generated." + std::to_string(i));
+    EXPECT_EQ(name_count(registry), 0u);
+
+    auto held = registry.intern("held");
+    auto copy = held;
+    EXPECT_EQ(registry.intern("held"), held);
+    auto configured = registry.intern("configured");
+    registry.keep(*configured);
+    configured.reset();
+    EXPECT_EQ(name_count(registry), 2u);
+
+    held.reset();
+    EXPECT_NE(registry.find_name("held"), nullptr);
+    EXPECT_EQ(copy->text, "held");
+    copy.reset();
+    EXPECT_EQ(registry.find_name("held"), nullptr);
+    EXPECT_EQ(name_count(registry), 1u);
+    EXPECT_NE(registry.find_name("configured"), nullptr);
+}
+
+TEST(async_pool, names_of_finished_tasks_stay_readable)
+{
+    stdex::detail::async_pool pool;
+    std::atomic<bool> release = { false };
+    auto id = pool.start("short lived", [&] {
+        while (!release)
+            std::this_thread::sleep_for(1ms);
+    });
+    auto task = pool.id(id);
+    release = true;
+    ASSERT_NE(task, nullptr);
+    pool.wait(id);
+    for (int i = 0; i < 100; i++)
+        pool.wait(pool.start("filler." + std::to_string(i), [] {}));
+    EXPECT_EQ(task->name, "short lived");
+}